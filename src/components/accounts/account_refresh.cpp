@@ -0,0 +1,405 @@
+#include "account_refresh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <latch>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "network/roblox.h"
+#include "core/logging.hpp"
+#include "system/main_thread.h"
+#include "system/threading.h"
+#include "system/timers.h"
+#include "ui/confirm.h"
+#include "../data.h"
+
+using namespace std;
+
+static constexpr int kMaxParallelism = 32;
+
+// What a worker reads: a copy, so g_accounts is only touched on the main thread.
+struct AccountSnapshot {
+    int id;
+    string cookie;
+    string userId;
+    string name;
+};
+
+// What a worker found out; unset fields leave the account as it was.
+struct AccountUpdate {
+    int id = 0;
+    bool invalidCookie = false;
+    bool deselect = false;
+    bool hasProfile = false;
+    string userId;
+    string username;
+    string displayName;
+    optional<string> status;
+    optional<time_t> banExpiry;
+    optional<string> voiceStatus;
+    optional<time_t> voiceBanExpiry;
+    uint64_t presenceUserId = 0; // non-zero: presence is fetched in the batch stage
+    optional<Roblox::PresenceData> presence;
+};
+
+struct PresenceTarget {
+    size_t update;
+    uint64_t userId;
+    string cookie;
+};
+
+struct StageTotals {
+    atomic<int64_t> moderationUs{0};
+    atomic<int64_t> profileUs{0};
+    atomic<int64_t> voiceUs{0};
+};
+
+static mutex s_statsMutex;
+static AccountRefresh::RefreshStats s_lastStats;
+
+static double msSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+template<typename F>
+static auto timed(atomic<int64_t> &totalUs, F &&f) {
+    auto start = chrono::steady_clock::now();
+    auto result = f();
+    totalUs += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+static void markModerated(AccountUpdate &u, const char *status, time_t banExpiry) {
+    u.status = status;
+    u.banExpiry = banExpiry;
+    u.voiceStatus = "N/A";
+    u.voiceBanExpiry = 0;
+    u.deselect = true;
+}
+
+// Moderation is checked exactly once per cookie; refreshBanInfo also seeds the
+// ban cache, so the later stages' canUseCookie checks don't ask again. Banned,
+// warned and terminated cookies stop here.
+static AccountUpdate refreshAccount(const AccountSnapshot &acct, StageTotals &totals) {
+    AccountUpdate u;
+    u.id = acct.id;
+    bool needsUserInfoUpdate = true;
+
+    // Try cookie first - it's the most authoritative source
+    if (!acct.cookie.empty()) {
+        auto banInfo = timed(totals.moderationUs, [&] { return Roblox::refreshBanInfo(acct.cookie); });
+        switch (banInfo.status) {
+            case Roblox::BanCheckResult::InvalidCookie:
+                u.invalidCookie = true;
+                break;
+            case Roblox::BanCheckResult::Banned:
+                markModerated(u, "Banned", banInfo.endDate);
+                return u;
+            case Roblox::BanCheckResult::Warned:
+                markModerated(u, "Warned", 0);
+                return u;
+            case Roblox::BanCheckResult::Terminated:
+                markModerated(u, "Terminated", 0); // Terminated accounts don't have an end date
+                return u;
+            case Roblox::BanCheckResult::Unbanned: {
+                auto userJson = timed(totals.profileUs, [&] { return Roblox::getAuthenticatedUser(acct.cookie); });
+                if (!userJson.empty()) {
+                    u.hasProfile = true;
+                    u.userId = to_string(userJson.value("id", 0ULL));
+                    u.username = userJson.value("name", "");
+                    u.displayName = userJson.value("displayName", "");
+                    needsUserInfoUpdate = false;
+
+                    try {
+                        uint64_t uid = stoull(u.userId);
+                        auto vs = timed(totals.voiceUs, [&] { return Roblox::getVoiceChatStatus(acct.cookie); });
+                        u.voiceStatus = vs.status;
+                        u.voiceBanExpiry = vs.bannedUntil;
+                        u.banExpiry = 0;
+                        u.presenceUserId = uid;
+                    } catch (const exception &e) {
+                        LOG_ERROR("Error getting presence: " + string(e.what()));
+                        u.status = "Error";
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    // Fall back to userId if cookie failed or is empty
+    if (needsUserInfoUpdate && !acct.userId.empty()) {
+        try {
+            stoull(acct.userId);
+            auto userInfo = timed(totals.profileUs, [&] { return Roblox::getUserInfo(acct.userId); });
+            if (userInfo.id != 0) {
+                u.hasProfile = true;
+                u.userId = acct.userId;
+                u.username = userInfo.username;
+                u.displayName = userInfo.displayName;
+                u.status = "Cookie Invalid";
+                u.voiceStatus = "N/A";
+                u.voiceBanExpiry = 0;
+            } else {
+                u.status = "Error: Invalid UserID";
+            }
+        } catch (const exception &e) {
+            char errorMsg[256];
+            snprintf(errorMsg, sizeof(errorMsg), "Error converting userId %s: %s", acct.userId.c_str(), e.what());
+            LOG_ERROR(errorMsg);
+            u.status = "Error: Invalid UserID";
+        }
+    }
+    return u;
+}
+
+// One presence request per 100 accounts, all in flight at once, instead of
+// one per account. The batches are sent with one member's cookie; Roblox only
+// reveals the place of users that cookie may see, so in-game accounts whose
+// location came back hidden are re-queried with their own cookie. Accounts
+// whose batch failed twice keep the status they had.
+static void refreshPresences(const vector<PresenceTarget> &targets, vector<AccountUpdate> &updates) {
+    if (targets.empty())
+        return;
+
+    vector<uint64_t> ids;
+    ids.reserve(targets.size());
+    for (const auto &t: targets)
+        ids.push_back(t.userId);
+
+    const string &firstCookie = targets.front().cookie;
+    auto presences = Roblox::getPresencesBatched(ids, firstCookie);
+    unordered_map<uint64_t, const string *> askedWith;
+    for (const auto &[userId, _]: presences)
+        askedWith[userId] = &firstCookie;
+
+    // Failed batches are retried once, together, with another member's cookie.
+    vector<uint64_t> missing;
+    const string *retryCookie = nullptr;
+    for (const auto &t: targets) {
+        if (presences.count(t.userId))
+            continue;
+        missing.push_back(t.userId);
+        if (!retryCookie && t.cookie != firstCookie)
+            retryCookie = &t.cookie;
+    }
+    if (!missing.empty() && retryCookie) {
+        for (auto &[userId, p]: Roblox::getPresencesBatched(missing, *retryCookie)) {
+            askedWith[userId] = retryCookie;
+            presences.emplace(userId, std::move(p));
+        }
+    }
+
+    size_t failed = 0;
+    for (const auto &t: targets) {
+        auto it = presences.find(t.userId);
+        if (it == presences.end()) {
+            ++failed;
+            continue;
+        }
+        Roblox::PresenceData p = std::move(it->second);
+        if (*askedWith[t.userId] != t.cookie && p.presence == "InGame" && p.placeId == 0) {
+            auto single = Roblox::getPresences({t.userId}, t.cookie);
+            auto sit = single.find(t.userId);
+            if (sit != single.end())
+                p = std::move(sit->second);
+        }
+        updates[t.update].presence = std::move(p);
+    }
+    if (failed)
+        LOG_ERROR("Presence unavailable for " + to_string(failed) + " accounts; keeping their last status");
+}
+
+static void applyUpdate(AccountData &acct, const AccountUpdate &u) {
+    if (u.hasProfile) {
+        acct.userId = u.userId;
+        acct.username = u.username;
+        acct.displayName = u.displayName;
+    }
+    if (u.status)
+        acct.status = *u.status;
+    if (u.banExpiry)
+        acct.banExpiry = *u.banExpiry;
+    if (u.voiceStatus)
+        acct.voiceStatus = *u.voiceStatus;
+    if (u.voiceBanExpiry)
+        acct.voiceBanExpiry = *u.voiceBanExpiry;
+    if (u.presence) {
+        acct.status = u.presence->presence;
+        acct.lastLocation = u.presence->lastLocation;
+        acct.placeId = u.presence->placeId;
+        acct.jobId = u.presence->jobId;
+    }
+}
+
+// Main thread only: the accounts may be added or removed there at any time.
+static vector<AccountSnapshot> snapshotAccounts() {
+    vector<AccountSnapshot> snapshot;
+    snapshot.reserve(g_accounts.size());
+    for (const auto &acct: g_accounts) {
+        if (acct.cookie.empty() && acct.userId.empty())
+            continue;
+        snapshot.push_back({acct.id, acct.cookie, acct.userId,
+                            acct.displayName.empty() ? acct.username : acct.displayName});
+    }
+    return snapshot;
+}
+
+namespace AccountRefresh {
+    // Blocking; runs on a worker and hands its results to the main thread.
+    static void refreshAccounts(const vector<AccountSnapshot> &snapshot) {
+        auto started = chrono::steady_clock::now();
+
+        // Per-account stages, a bounded number of accounts at a time: this
+        // thread plus helpers on the pool's background lane.
+        int parallelism = clamp(g_refreshParallelism, 1, kMaxParallelism);
+        size_t workerCount = (min)(static_cast<size_t>(parallelism), snapshot.size());
+        vector<AccountUpdate> updates(snapshot.size());
+        StageTotals totals;
+        atomic<size_t> next{0};
+        auto work = [&] {
+            for (size_t i = next++; i < snapshot.size(); i = next++)
+                updates[i] = refreshAccount(snapshot[i], totals);
+        };
+        size_t helpers = workerCount > 0 ? workerCount - 1 : 0;
+        latch helpersDone(static_cast<ptrdiff_t>(helpers));
+        for (size_t w = 0; w < helpers; ++w) {
+            Threading::background([&] {
+                work();
+                helpersDone.count_down();
+            });
+        }
+        work();
+        helpersDone.wait();
+
+        // Presence for everyone who got this far, in as few requests as possible.
+        auto presenceStart = chrono::steady_clock::now();
+        vector<PresenceTarget> presenceTargets;
+        for (size_t i = 0; i < updates.size(); ++i) {
+            if (updates[i].presenceUserId != 0)
+                presenceTargets.push_back({i, updates[i].presenceUserId, snapshot[i].cookie});
+        }
+        refreshPresences(presenceTargets, updates);
+        double presenceMs = msSince(presenceStart);
+
+        vector<int> invalidIds;
+        string names;
+        for (size_t i = 0; i < updates.size(); ++i) {
+            if (!updates[i].invalidCookie)
+                continue;
+            invalidIds.push_back(updates[i].id);
+            if (!names.empty())
+                names += ", ";
+            names += snapshot[i].name;
+        }
+
+        RefreshStats stats;
+        stats.accounts = snapshot.size();
+        stats.parallelism = parallelism;
+        stats.totalMs = msSince(started);
+        stats.moderationMs = totals.moderationUs / 1000.0;
+        stats.profileMs = totals.profileUs / 1000.0;
+        stats.voiceMs = totals.voiceUs / 1000.0;
+        stats.presenceMs = presenceMs;
+        {
+            lock_guard<mutex> lock(s_statsMutex);
+            s_lastStats = stats;
+        }
+        char summary[256];
+        snprintf(summary, sizeof(summary),
+                 "Refreshed %zu accounts in %.0f ms (x%d): moderation %.0f ms, profile %.0f ms, voice %.0f ms, "
+                 "presence %.0f ms",
+                 stats.accounts, stats.totalMs, stats.parallelism, stats.moderationMs, stats.profileMs,
+                 stats.voiceMs, stats.presenceMs);
+        LOG_INFO(summary);
+
+        MainThread::Post([updates = std::move(updates), invalidIds, names]() {
+            for (const auto &u: updates) {
+                auto it = find_if(g_accounts.begin(), g_accounts.end(),
+                                  [&](const AccountData &a) { return a.id == u.id; });
+                if (it == g_accounts.end())
+                    continue; // removed while the refresh was running
+                applyUpdate(*it, u);
+                if (u.deselect)
+                    g_selectedAccountIds.erase(u.id);
+            }
+            Data::SaveAccounts();
+            LOG_INFO("Loaded accounts and refreshed statuses");
+
+            if (invalidIds.empty())
+                return;
+            char buf[512];
+            snprintf(buf, sizeof(buf), "Invalid cookies for: %s. Remove them?", names.c_str());
+            ConfirmPopup::Add(buf, [invalidIds]() {
+                erase_if(g_accounts, [&](const AccountData &a) {
+                    return find(invalidIds.begin(), invalidIds.end(), a.id) != invalidIds.end();
+                });
+                for (int id: invalidIds) {
+                    g_selectedAccountIds.erase(id);
+                }
+                Data::SaveAccounts();
+            });
+        });
+    }
+
+    // Periodic refresh schedule; the timer is armed only between runs.
+    static mutex s_scheduleMutex;
+    static Timers::Handle s_nextRefresh = 0;
+    static chrono::steady_clock::time_point s_lastFinished{};
+    static int s_intervalMinutes = 1;
+    static bool s_refreshRunning = false;
+
+    static void beginPeriodicRefresh();
+
+    static void armNextRefreshLocked() {
+        Timers::cancel(s_nextRefresh);
+        s_nextRefresh = Timers::at(s_lastFinished + chrono::minutes(s_intervalMinutes),
+                                   [] { MainThread::Post(beginPeriodicRefresh); });
+    }
+
+    // Main thread: snapshots the accounts, then refreshes them on the
+    // background lane and arms the next run once that finishes.
+    static void beginPeriodicRefresh() {
+        {
+            lock_guard<mutex> lock(s_scheduleMutex);
+            s_refreshRunning = true;
+            s_nextRefresh = 0;
+        }
+        Threading::background([snapshot = snapshotAccounts()] {
+            LOG_INFO("Refreshing account statuses...");
+            refreshAccounts(snapshot);
+            LOG_INFO("Refreshed account statuses");
+            lock_guard<mutex> lock(s_scheduleMutex);
+            s_refreshRunning = false;
+            s_lastFinished = chrono::steady_clock::now();
+            armNextRefreshLocked();
+        });
+    }
+
+    void StartPeriodicRefresh() {
+        {
+            lock_guard<mutex> lock(s_scheduleMutex);
+            s_intervalMinutes = (max)(g_statusRefreshInterval, 1);
+        }
+        beginPeriodicRefresh();
+    }
+
+    void SetRefreshInterval(int minutes) {
+        lock_guard<mutex> lock(s_scheduleMutex);
+        s_intervalMinutes = (max)(minutes, 1);
+        // A run in progress arms the timer with the new interval when it ends.
+        if (!s_refreshRunning && s_nextRefresh != 0)
+            armNextRefreshLocked();
+    }
+
+    RefreshStats LastStats() {
+        lock_guard<mutex> lock(s_statsMutex);
+        return s_lastStats;
+    }
+}
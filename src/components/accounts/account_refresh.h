@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+namespace AccountRefresh {
+	// Timings of the last completed refresh. Per-account stages are summed
+	// over all accounts, so with parallelism they can exceed totalMs.
+	struct RefreshStats {
+		size_t accounts = 0;
+		int parallelism = 0;
+		double totalMs = 0.0;
+		double moderationMs = 0.0;
+		double profileMs = 0.0;
+		double voiceMs = 0.0;
+		double presenceMs = 0.0;
+	};
+
+	// Re-checks ban state, profile, presence and voice status of every account
+	// in g_accounts and saves them: now, then again g_statusRefreshInterval
+	// minutes after each refresh finishes. Call on the main thread; the
+	// accounts are copied there and refreshed on the background lane.
+	void StartPeriodicRefresh();
+
+	// Re-arms the pending periodic refresh for a new interval, counted from
+	// the end of the last refresh (so it fires at once if that has passed).
+	void SetRefreshInterval(int minutes);
+
+	RefreshStats LastStats();
+}
@@ -195,8 +195,13 @@ void RenderAccountContextMenu(AccountData &account, const string &unique_context
                             thread_local mt19937_64 rng{random_device{}()};
                             static uniform_int_distribution<int> d1(100000, 130000), d2(100000, 900000);
                             string out;
+                            vector<string> usable;
                             for (auto &p : accs) {
-                                string ticket = Roblox::fetchAuthTicket(p.second);
+                                if (Roblox::canUseCookie(p.second)) usable.push_back(p.second);
+                            }
+                            if (usable.size() > 1) Roblox::AuthTicketPool::instance().prefill(usable);
+                            for (const auto &cookie : usable) {
+                                string ticket = Roblox::takeAuthTicket(cookie);
                                 if (ticket.empty()) continue;
                                 string browserTracker = to_string(d1(rng)) + to_string(d2(rng));
                                 string placeLauncherUrl =
@@ -245,7 +250,8 @@ void RenderAccountContextMenu(AccountData &account, const string &unique_context
                                 thread_local mt19937_64 rng{random_device{}()};
                                 static uniform_int_distribution<int> d1(100000, 130000), d2(100000, 900000);
                                 string browserTracker = to_string(d1(rng)) + to_string(d2(rng));
-                                string ticket = Roblox::fetchAuthTicket(acc_cookie);
+                                if (!Roblox::canUseCookie(acc_cookie)) return;
+                                string ticket = Roblox::takeAuthTicket(acc_cookie);
                                 if (ticket.empty()) return;
                                 string placeLauncherUrl =
                                         "https://assetgame.roblox.com/game/PlaceLauncher.ashx?request=RequestGame%26placeId="
@@ -259,7 +259,7 @@ void RenderAccountsTable(vector<AccountData> &accounts_to_display, const char *t
 								it->voiceBanExpiry = vs.bannedUntil;
 							}
 							s_voiceUpdateInProgress.erase(accId);
-							Data::SaveAccounts();
+							Data::ScheduleSaveAccounts();
 						}); });
 				}
 			}
@@ -5,6 +5,8 @@
 #include "ui/image.h"
 #include "system/threading.h"
 #include "system/main_thread.h"
+#include "network/http.hpp"
+#include "network/roblox/thumbnails.h"
 #include "../data.h"
 #include <nlohmann/json.hpp>
 #include <vector>
@@ -12,6 +14,8 @@
 #include <algorithm>
 #include <cstring>
 #include <cctype>
+#include <chrono>
+#include <string_view>
 #include <cmath>
 #include <imgui_internal.h>
 #include <unordered_set>
@@ -51,9 +55,30 @@ static bool s_equippedLoading = false;
 static bool s_equippedFailed = false;
 static std::vector<uint64_t> s_equippedAssetIds;
 
-// Limit concurrent thumbnail fetches to avoid hammering the thumbnail API.
-static int s_activeThumbLoads = 0;
-constexpr int kMaxConcurrentThumbLoads = 24; // tweak as needed
+// Cancelled whenever the displayed user changes so the previous user's
+// avatar/category/inventory fetches stop instead of finishing in the background.
+static HttpClient::CancelToken s_userCancel = HttpClient::CancelToken::create();
+constexpr auto kInventoryRequestTimeout = std::chrono::seconds(20);
+
+// Starts loading the 75x75 thumbnail of `assetId` unless it is already
+// loaded, loading or failed. The service batches these across the grid.
+static void requestThumb(uint64_t assetId) {
+    auto &thumb = s_thumbCache[assetId];
+    if (thumb.srv || thumb.loading || thumb.failed)
+        return;
+    thumb.loading = true;
+    Roblox::thumbnails().request(Roblox::ThumbnailKind::Asset, assetId, "75x75",
+                                 [assetId, token = s_userCancel](const std::string &image) {
+        MainThread::Post([assetId, token, data = image]() mutable {
+            if (token.cancelled())
+                return; // the cache was cleared for another user
+            auto &ti = s_thumbCache[assetId];
+            ti.loading = false;
+            ti.failed = data.empty() ||
+                        !LoadTextureFromMemory(data.data(), data.size(), &ti.srv, &ti.width, &ti.height);
+        });
+    });
+}
 
 void RenderInventoryTab() {
     // Persistent state across frames
@@ -130,6 +155,8 @@ void RenderInventoryTab() {
     // If the displayed user changed, clear caches
     if (currentUserId != s_catUserId) {
         s_catUserId = currentUserId;
+        s_userCancel.cancel();
+        s_userCancel = HttpClient::CancelToken::create();
         s_categories.clear();
         s_catLoading = false;
         s_catFailed = false;
@@ -165,57 +192,14 @@ void RenderInventoryTab() {
         s_started = true;
         s_loading = true;
 
-        Threading::newThread([currentUserId] {
-            // 420×420 PNG full-body avatar image
-            std::string metaUrl =
-                    "https://thumbnails.roblox.com/v1/users/avatar?userIds=" + std::to_string(currentUserId) +
-                    "&size=420x420&format=Png";
-
-            auto metaResp = HttpClient::get(metaUrl);
-            if (metaResp.status_code != 200 || metaResp.text.empty()) {
-                MainThread::Post([] {
-                    s_loading = false;
-                    s_failed = true;
-                });
-                return;
-            }
-
-            nlohmann::json metaJson = HttpClient::decode(metaResp);
-            std::string avatarUrl;
-            try {
-                if (metaJson.contains("data") && !metaJson["data"].empty() &&
-                    metaJson["data"][0].contains("imageUrl")) {
-                    avatarUrl = metaJson["data"][0]["imageUrl"].get<std::string>();
-                }
-            } catch (...) {
-                avatarUrl.clear();
-            }
-
-            if (avatarUrl.empty()) {
-                MainThread::Post([] {
-                    s_loading = false;
-                    s_failed = true;
-                });
-                return;
-            }
-
-            auto imgResp = HttpClient::get(avatarUrl);
-            if (imgResp.status_code != 200 || imgResp.text.empty()) {
-                MainThread::Post([] {
-                    s_loading = false;
-                    s_failed = true;
-                });
-                return;
-            }
-
-            std::string data = std::move(imgResp.text);
-
-            MainThread::Post([data = std::move(data)]() mutable {
-                if (LoadTextureFromMemory(data.data(), data.size(), &s_texture, &s_imageWidth, &s_imageHeight)) {
-                    s_failed = false;
-                } else {
-                    s_failed = true;
-                }
+        // 420×420 PNG full-body avatar image
+        Roblox::thumbnails().request(Roblox::ThumbnailKind::Avatar, currentUserId, "420x420",
+                                     [token = s_userCancel](const std::string &image) {
+            MainThread::Post([token, data = image]() mutable {
+                if (token.cancelled())
+                    return;
+                s_failed = data.empty() ||
+                           !LoadTextureFromMemory(data.data(), data.size(), &s_texture, &s_imageWidth, &s_imageHeight);
                 s_loading = false;
             });
         });
@@ -224,11 +208,14 @@ void RenderInventoryTab() {
     // Kick off categories fetch once
     if (!s_catLoading && s_categories.empty() && !s_catFailed) {
         s_catLoading = true;
-        Threading::newThread([currentUserId, cookie = currentCookie] {
+        Threading::newThread([currentUserId, cookie = currentCookie, token = s_userCancel] {
+            HttpClient::RequestScope scope(token, kInventoryRequestTimeout);
             std::string url = "https://inventory.roblox.com/v1/users/" + std::to_string(currentUserId) + "/categories";
             auto resp = HttpClient::get(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
             if (resp.status_code != 200 || resp.text.empty()) {
-                MainThread::Post([] {
+                MainThread::Post([token] {
+                    if (token.cancelled())
+                        return;
                     s_catLoading = false;
                     s_catFailed = true;
                 });
@@ -238,7 +225,9 @@ void RenderInventoryTab() {
             try {
                 j = HttpClient::decode(resp);
             } catch (...) {
-                MainThread::Post([] {
+                MainThread::Post([token] {
+                    if (token.cancelled())
+                        return;
                     s_catLoading = false;
                     s_catFailed = true;
                 });
@@ -264,7 +253,9 @@ void RenderInventoryTab() {
                 }
             } catch (...) {
             }
-            MainThread::Post([categories = std::move(categories)]() mutable {
+            MainThread::Post([token, categories = std::move(categories)]() mutable {
+                if (token.cancelled())
+                    return;
                 s_categories = std::move(categories);
                 s_catLoading = false;
                 s_catFailed = s_categories.empty();
@@ -294,26 +285,29 @@ void RenderInventoryTab() {
     if (currentUserId != 0 && currentUserId != s_equippedUserId && !s_equippedLoading) {
         s_equippedLoading = true;
         s_equippedFailed = false;
-        Threading::newThread([uid = currentUserId]() {
+        Threading::newThread([uid = currentUserId, token = s_userCancel]() {
+            HttpClient::RequestScope scope(token, kInventoryRequestTimeout);
             std::string url = "https://avatar.roblox.com/v1/users/" + std::to_string(uid) + "/currently-wearing";
             auto resp = HttpClient::get(url);
-            if (resp.status_code != 200 || resp.text.empty()) {
-                MainThread::Post([uid]() {
+            auto fail = [uid, token] {
+                MainThread::Post([uid, token]() {
+                    // Discard if user changed while the request was in-flight
+                    if (token.cancelled() || uid != s_catUserId)
+                        return;
                     s_equippedUserId = uid;
                     s_equippedFailed = true;
                     s_equippedLoading = false;
                 });
+            };
+            if (resp.status_code != 200 || resp.text.empty()) {
+                fail();
                 return;
             }
             nlohmann::json j;
             try {
                 j = HttpClient::decode(resp);
             } catch (...) {
-                MainThread::Post([uid]() {
-                    s_equippedUserId = uid;
-                    s_equippedFailed = true;
-                    s_equippedLoading = false;
-                });
+                fail();
                 return;
             }
             std::vector<uint64_t> ids;
@@ -329,9 +323,9 @@ void RenderInventoryTab() {
             } catch (...) {
             }
 
-            MainThread::Post([uid, ids = std::move(ids)]() mutable {
+            MainThread::Post([uid, token, ids = std::move(ids)]() mutable {
                 // Discard if user changed while the request was in-flight
-                if (uid != s_catUserId)
+                if (token.cancelled() || uid != s_catUserId)
                     return;
 
                 s_equippedUserId = uid;
@@ -362,54 +356,8 @@ void RenderInventoryTab() {
             if (index % equipColumns != 0)
                 SameLine();
 
+            requestThumb(aid);
             auto &thumb = s_thumbCache[aid];
-            if (!thumb.srv && !thumb.loading && !thumb.failed && s_activeThumbLoads < kMaxConcurrentThumbLoads) {
-                thumb.loading = true;
-                ++s_activeThumbLoads;
-                Threading::newThread([assetId = aid]() {
-                    // identical download logic as before
-                    auto finish = [assetId](bool success) {
-                        MainThread::Post([assetId, success]() {
-                            auto &ti = s_thumbCache[assetId];
-                            ti.loading = false;
-                            ti.failed = !success;
-                            --s_activeThumbLoads;
-                        });
-                    };
-                    std::string metaUrl = "https://thumbnails.roblox.com/v1/assets?assetIds=" + std::to_string(assetId)
-                                          + "&size=75x75&format=Png";
-                    auto metaResp = HttpClient::get(metaUrl);
-                    if (metaResp.status_code != 200 || metaResp.text.empty()) {
-                        finish(false);
-                        return;
-                    }
-                    nlohmann::json metaJson = HttpClient::decode(metaResp);
-                    std::string imageUrl;
-                    try {
-                        if (metaJson.contains("data") && !metaJson["data"].empty()) {
-                            const auto &d = metaJson["data"][0];
-                            if (d.contains("imageUrl")) imageUrl = d["imageUrl"].get<std::string>();
-                        }
-                    } catch (...) { imageUrl.clear(); }
-                    if (imageUrl.empty()) {
-                        finish(false);
-                        return;
-                    }
-                    auto imgResp = HttpClient::get(imageUrl);
-                    if (imgResp.status_code != 200 || imgResp.text.empty()) {
-                        finish(false);
-                        return;
-                    }
-                    std::string data = std::move(imgResp.text);
-                    MainThread::Post([assetId, data = std::move(data)]() mutable {
-                        auto &ti = s_thumbCache[assetId];
-                        bool ok = LoadTextureFromMemory(data.data(), data.size(), &ti.srv, &ti.width, &ti.height);
-                        ti.loading = false;
-                        ti.failed = !ok;
-                        --s_activeThumbLoads;
-                    });
-                });
-            }
 
             // Ensure unique ImGui IDs for each equipped item to avoid conflicts.
             PushID(index);
@@ -532,56 +480,47 @@ void RenderInventoryTab() {
     if (itInv == s_cachedInventories.end() && !s_invLoading) {
         s_invLoading = true;
         s_invFailed = false;
-        Threading::newThread([currentUserId, cookie = currentCookie, assetTypeId] {
+        Threading::newThread([currentUserId, cookie = currentCookie, assetTypeId, token = s_userCancel] {
+            HttpClient::RequestScope scope(token, kInventoryRequestTimeout);
             std::vector<InventoryItem> items;
 
             std::string cursor; // pagination cursor, empty for first page
             bool anyError = false;
-            while (!anyError) {
+            while (!anyError && !token.cancelled()) {
                 std::string url = "https://inventory.roblox.com/v2/users/" + std::to_string(currentUserId) +
                                   "/inventory/" + std::to_string(assetTypeId) + "?limit=100&sortOrder=Asc";
                 if (!cursor.empty())
                     url += "&cursor=" + cursor;
 
-                auto resp = HttpClient::get(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-                if (resp.status_code != 200 || resp.text.empty()) {
-                    anyError = true;
-                    break;
-                }
-
-                nlohmann::json j;
-                try {
-                    j = HttpClient::decode(resp);
-                } catch (...) {
+                // Pages are decoded into items as they stream in, without a DOM.
+                std::string nextCursor;
+                auto sax = HttpClient::makeArraySax(
+                    "data", items,
+                    [](InventoryItem &ii, std::string_view key, nlohmann::json &v) {
+                        if (key == "assetId")
+                            ii.assetId = HttpClient::saxUint(v);
+                        else if (key == "assetName")
+                            ii.assetName = HttpClient::saxString(v);
+                    },
+                    [&nextCursor](std::string_view key, nlohmann::json &v) {
+                        if (key == "nextPageCursor")
+                            nextCursor = HttpClient::saxString(v);
+                    });
+                auto resp = HttpClient::getSax(url, sax, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
+                if (resp.status_code != 200 || !resp.parsed) {
                     anyError = true;
                     break;
                 }
-
-                try {
-                    if (j.contains("data")) {
-                        for (auto &it: j["data"]) {
-                            InventoryItem ii;
-                            ii.assetId = it.value("assetId", 0);
-                            ii.assetName = it.value("assetName", "");
-                            items.push_back(std::move(ii));
-                        }
-                    }
-                } catch (...) {
-                }
-
-                // Check for pagination cursor
-                cursor.clear();
-                try {
-                    if (j.contains("nextPageCursor") && !j["nextPageCursor"].is_null())
-                        cursor = j["nextPageCursor"].get<std::string>();
-                } catch (...) {
-                }
+                cursor = std::move(nextCursor);
 
                 if (cursor.empty())
                     break; // no more pages
             }
 
-            MainThread::Post([assetTypeId, anyError, items = std::move(items)]() mutable {
+            MainThread::Post([token, assetTypeId, anyError, items = std::move(items)]() mutable {
+                // A newer user's state must not receive this user's items.
+                if (token.cancelled())
+                    return;
                 if (!anyError) {
                     s_cachedInventories[assetTypeId] = std::move(items);
                     s_invFailed = false;
@@ -658,64 +597,8 @@ void RenderInventoryTab() {
                         SameLine();
 
                     // Thumbnail handling (only start downloads for on-screen items)
+                    requestThumb(itm.assetId);
                     auto &thumb = s_thumbCache[itm.assetId];
-                    if (!thumb.srv && !thumb.loading && !thumb.failed && s_activeThumbLoads <
-                        kMaxConcurrentThumbLoads) {
-                        thumb.loading = true;
-                        ++s_activeThumbLoads;
-                        Threading::newThread([assetId = itm.assetId]() {
-                            auto finishWithState = [assetId](bool success) {
-                                MainThread::Post([assetId, success]() {
-                                    auto &ti = s_thumbCache[assetId];
-                                    ti.loading = false;
-                                    ti.failed = !success;
-                                    --s_activeThumbLoads;
-                                });
-                            };
-
-                            std::string metaUrl = "https://thumbnails.roblox.com/v1/assets?assetIds=" + std::to_string(
-                                                      assetId) +
-                                                  "&size=75x75&format=Png";
-                            auto metaResp = HttpClient::get(metaUrl);
-                            if (metaResp.status_code != 200 || metaResp.text.empty()) {
-                                finishWithState(false);
-                                return;
-                            }
-
-                            nlohmann::json metaJson = HttpClient::decode(metaResp);
-                            std::string imageUrl;
-                            try {
-                                if (metaJson.contains("data") && !metaJson["data"].empty()) {
-                                    const auto &d = metaJson["data"][0];
-                                    if (d.contains("imageUrl"))
-                                        imageUrl = d["imageUrl"].get<std::string>();
-                                }
-                            } catch (...) {
-                                imageUrl.clear();
-                            }
-
-                            if (imageUrl.empty()) {
-                                finishWithState(false);
-                                return;
-                            }
-
-                            auto imgResp = HttpClient::get(imageUrl);
-                            if (imgResp.status_code != 200 || imgResp.text.empty()) {
-                                finishWithState(false);
-                                return;
-                            }
-
-                            std::string data = std::move(imgResp.text);
-                            MainThread::Post([assetId, data = std::move(data)]() mutable {
-                                auto &ti = s_thumbCache[assetId];
-                                bool ok = LoadTextureFromMemory(data.data(), data.size(), &ti.srv, &ti.width,
-                                                                &ti.height);
-                                ti.loading = false;
-                                ti.failed = !ok;
-                                --s_activeThumbLoads;
-                            });
-                        });
-                    }
 
                     PushID(itemIndex);
                     bool itemClicked = false;
@@ -3,10 +3,13 @@
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include <stdexcept>
 #include <filesystem>
 #include <unordered_map>
 #include <unordered_set>
+#include <atomic>
+#include <chrono>
 
 #ifdef _WIN32
     #define WIN32_LEAN_AND_MEAN
@@ -22,6 +25,8 @@
 #include "core/base64.h"
 #include "core/logging.hpp"
 #include "core/app_state.h"
+#include "system/main_thread.h"
+#include "system/timers.h"
 
 using namespace std;
 using json = nlohmann::json;
@@ -38,9 +43,12 @@ int g_defaultAccountId = -1;
 array<char, 128> s_jobIdBuffer = {};
 array<char, 128> s_playerBuffer = {};
 int g_statusRefreshInterval = 1;
+int g_refreshParallelism = 8;
 bool g_checkUpdatesOnStartup = true;
 bool g_killRobloxOnLaunch = false;
 bool g_clearCacheOnLaunch = false;
+bool g_preMintAuthTickets = false;
+int g_mainThreadBudgetMs = 4;
 
 #ifdef _WIN32
 // Windows DPAPI encryption
@@ -354,9 +362,12 @@ namespace Data {
             fin >> j;
             g_defaultAccountId = j.value("defaultAccountId", -1);
             g_statusRefreshInterval = j.value("statusRefreshInterval", 1);
+            g_refreshParallelism = j.value("refreshParallelism", 8);
             g_checkUpdatesOnStartup = j.value("checkUpdatesOnStartup", true);
             g_killRobloxOnLaunch = j.value("killRobloxOnLaunch", false);
             g_clearCacheOnLaunch = j.value("clearCacheOnLaunch", false);
+            g_preMintAuthTickets = j.value("preMintAuthTickets", false);
+            g_mainThreadBudgetMs = std::clamp(j.value("mainThreadBudgetMs", 4), 1, 50);
             g_multiRobloxEnabled = j.value("multiRobloxEnabled", false);
             LOG_INFO("Default account ID = " + std::to_string(g_defaultAccountId));
             LOG_INFO("Status refresh interval = " + std::to_string(g_statusRefreshInterval));
@@ -369,9 +380,12 @@ namespace Data {
         nlohmann::json j;
         j["defaultAccountId"] = g_defaultAccountId;
         j["statusRefreshInterval"] = g_statusRefreshInterval;
+        j["refreshParallelism"] = g_refreshParallelism;
         j["checkUpdatesOnStartup"] = g_checkUpdatesOnStartup;
         j["killRobloxOnLaunch"] = g_killRobloxOnLaunch;
         j["clearCacheOnLaunch"] = g_clearCacheOnLaunch;
+        j["preMintAuthTickets"] = g_preMintAuthTickets;
+        j["mainThreadBudgetMs"] = g_mainThreadBudgetMs;
         j["multiRobloxEnabled"] = g_multiRobloxEnabled;
         std::string path = MakePath(filename);
         std::ofstream out{path};
@@ -383,6 +397,35 @@ namespace Data {
         LOG_INFO("Saved settings");
     }
 
+    static constexpr auto kSaveDebounce = chrono::milliseconds(750);
+    static atomic<bool> s_settingsDirty{false};
+    static atomic<bool> s_accountsDirty{false};
+
+    static Timers::Debouncer &saveDebouncer() {
+        static auto *debouncer = new Timers::Debouncer(kSaveDebounce);
+        return *debouncer;
+    }
+
+    static void scheduleSave(atomic<bool> &dirty) {
+        dirty = true;
+        saveDebouncer().call([] { MainThread::Post(SavePending); });
+    }
+
+    void ScheduleSaveSettings() {
+        scheduleSave(s_settingsDirty);
+    }
+
+    void ScheduleSaveAccounts() {
+        scheduleSave(s_accountsDirty);
+    }
+
+    void SavePending() {
+        if (s_settingsDirty.exchange(false))
+            SaveSettings();
+        if (s_accountsDirty.exchange(false))
+            SaveAccounts();
+    }
+
     void LoadFriends(const std::string &filename) {
         std::string path = MakePath(filename);
         std::ifstream fin{path};
@@ -56,9 +56,12 @@ extern ImVec4 g_accentColor;
 
 extern int g_defaultAccountId;
 extern int g_statusRefreshInterval;
+extern int g_refreshParallelism; // accounts refreshed concurrently
 extern bool g_checkUpdatesOnStartup;
 extern bool g_killRobloxOnLaunch;
 extern bool g_clearCacheOnLaunch;
+extern bool g_preMintAuthTickets; // mint launch tickets for selected accounts ahead of time
+extern int g_mainThreadBudgetMs; // time per frame spent on work posted to the UI thread
 extern std::array<char, 128> s_jobIdBuffer;
 extern std::array<char, 128> s_playerBuffer;
 
@@ -85,6 +88,15 @@ namespace Data {
 
 	void SaveFriends(const std::string &filename = "friends.json");
 
+	// Save once edits settle instead of on every change; for changes that
+	// arrive in bursts. Main thread only, like the Save* calls.
+	void ScheduleSaveSettings();
+
+	void ScheduleSaveAccounts();
+
+	// Writes anything still waiting on a scheduled save; call before exit.
+	void SavePending();
+
 
 	std::string StorageFilePath(const std::string &filename);
 }
@@ -0,0 +1,151 @@
+#include "decode_benchmark.h"
+
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "network/roblox.h"
+
+using namespace std;
+using nlohmann::json;
+
+template<typename F>
+static double msPerRun(int iterations, F &&f) {
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		f();
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / iterations;
+}
+
+static string serversDocument(size_t n) {
+	json data = json::array();
+	for (size_t i = 0; i < n; ++i) {
+		json tokens = json::array();
+		for (int t = 0; t < 8; ++t)
+			tokens.push_back("A1B2C3D4E5F6" + to_string(i * 8 + t));
+		data.push_back({
+			{"id", "6f1c2d3e-4a5b-6c7d-8e9f-" + to_string(100000000000 + i)},
+			{"maxPlayers", 50}, {"playing", static_cast<int>(i % 50)}, {"playerTokens", tokens},
+			{"players", json::array()}, {"fps", 59.5 + (i % 10) / 10.0}, {"ping", 40 + static_cast<int>(i % 90)}
+		});
+	}
+	return json{{"previousPageCursor", nullptr}, {"nextPageCursor", "eyJrZXkiOiJwYWdlMiJ9"}, {"data", data}}.dump();
+}
+
+static string friendsDocument(size_t n) {
+	json data = json::array();
+	for (size_t i = 0; i < n; ++i) {
+		data.push_back({
+			{"isOnline", i % 3 == 0}, {"presenceType", static_cast<int>(i % 4)}, {"isDeleted", false},
+			{"friendFrequentScore", 0}, {"friendFrequentRank", 1}, {"hasVerifiedBadge", false},
+			{"description", nullptr}, {"created", "0001-01-01T05:51:00Z"}, {"isBanned", false},
+			{"externalAppDisplayName", nullptr}, {"id", 1000000 + i},
+			{"name", "friend_" + to_string(i)}, {"displayName", "Friend " + to_string(i)}
+		});
+	}
+	return json{{"data", data}}.dump();
+}
+
+static string friendRequestsDocument(size_t n) {
+	json data = json::array();
+	for (size_t i = 0; i < n; ++i) {
+		data.push_back({
+			{"friendRequest", {
+				{"sentAt", "2024-05-01T12:00:00.000Z"}, {"senderId", 2000000 + i},
+				{"sourceUniverseId", 1000 + i}, {"originSourceType", "PlayerSearch"}
+			}},
+			{"mutualFriendsList", {"mutual_a", "mutual_b", "mutual_c"}},
+			{"hasVerifiedBadge", false}, {"description", "Hello there"}, {"created", "2019-02-03T04:05:06Z"},
+			{"isBanned", false}, {"id", 2000000 + i},
+			{"name", "requester_" + to_string(i)}, {"displayName", "Requester " + to_string(i)}
+		});
+	}
+	return json{{"previousPageCursor", nullptr}, {"nextPageCursor", "cursor2"}, {"data", data}}.dump();
+}
+
+// The DOM walks below are what the request paths did before they moved to
+// SAX decoders.
+static size_t friendsViaDom(const string &body) {
+	json j = json::parse(body);
+	vector<FriendInfo> out;
+	for (const auto &item: j["data"]) {
+		FriendInfo f;
+		f.id = item.value("id", 0ULL);
+		f.displayName = item.value("displayName", "");
+		f.username = item.value("name", "");
+		out.push_back(std::move(f));
+	}
+	return out.size();
+}
+
+static size_t friendRequestsViaDom(const string &body) {
+	json j = json::parse(body);
+	vector<Roblox::IncomingFriendRequest> out;
+	for (const auto &it: j["data"]) {
+		Roblox::IncomingFriendRequest r;
+		r.userId = it.value("id", 0ULL);
+		r.username = it.value("name", "");
+		r.displayName = it.value("displayName", "");
+		const auto &fr = it["friendRequest"];
+		r.sentAt = fr.value("sentAt", "");
+		r.originSourceType = fr.value("originSourceType", "");
+		r.sourceUniverseId = fr.value("sourceUniverseId", 0ULL);
+		for (const auto &m: it["mutualFriendsList"])
+			r.mutuals.push_back(m.get<string>());
+		out.push_back(std::move(r));
+	}
+	return out.size();
+}
+
+template<typename Dom, typename Sax>
+static Diagnostics::DecodeBenchmarkRow measure(const char *name, const string &body, size_t items, int iterations,
+                                               Dom &&dom, Sax &&sax) {
+	Diagnostics::DecodeBenchmarkRow row;
+	row.name = name;
+	row.bytes = body.size();
+	row.items = items;
+	row.iterations = iterations;
+	dom();
+	sax(); // warm up both paths before timing
+	row.domMs = msPerRun(iterations, dom);
+	row.saxMs = msPerRun(iterations, sax);
+	return row;
+}
+
+namespace Diagnostics {
+	vector<DecodeBenchmarkRow> RunDecodeBenchmark() {
+		vector<DecodeBenchmarkRow> rows;
+
+		string servers = serversDocument(100);
+		rows.push_back(measure("Server page", servers, 100, 200,
+		                       [&] { return Roblox::parseServerPage(json::parse(servers)).data.size(); },
+		                       [&] {
+			                       Roblox::ServerPage page;
+			                       Roblox::decodeServerPage(servers, page);
+			                       return page.data.size();
+		                       }));
+
+		string friends = friendsDocument(2000);
+		rows.push_back(measure("Friends list", friends, 2000, 20,
+		                       [&] { return friendsViaDom(friends); },
+		                       [&] {
+			                       Roblox::FriendsPage page;
+			                       auto sax = Roblox::friendsPageSax(page);
+			                       HttpClient::saxParse(friends, sax);
+			                       return page.data.size();
+		                       }));
+
+		string requests = friendRequestsDocument(100);
+		rows.push_back(measure("Friend requests", requests, 100, 200,
+		                       [&] { return friendRequestsViaDom(requests); },
+		                       [&] {
+			                       Roblox::FriendRequestsPage page;
+			                       auto sax = Roblox::friendRequestsPageSax(page);
+			                       HttpClient::saxParse(requests, sax);
+			                       return page.data.size();
+		                       }));
+		return rows;
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Diagnostics {
+    struct DecodeBenchmarkRow {
+        std::string name;
+        size_t bytes = 0;       // size of one document
+        size_t items = 0;       // elements per document
+        int iterations = 0;
+        double domMs = 0.0;     // per document: json::parse + walk into structs
+        double saxMs = 0.0;     // per document: SAX decoder straight into structs
+    };
+
+    // Decodes synthetic Roblox listings with both paths. Blocking; takes a
+    // second or two, so run it off the main thread.
+    std::vector<DecodeBenchmarkRow> RunDecodeBenchmark();
+}
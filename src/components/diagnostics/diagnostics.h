@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+
+namespace Diagnostics {
+    void RenderDiagnosticsTab();
+
+    // Everything shown in the panel as pretty-printed JSON.
+    std::string DumpJson();
+}
@@ -0,0 +1,227 @@
+#include "diagnostics.h"
+#include <imgui.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "../data.h"
+#include "../accounts/account_refresh.h"
+#include "decode_benchmark.h"
+#include "network/http.hpp"
+#include "core/logging.hpp"
+#include "system/main_thread.h"
+#include "system/threading.h"
+#include "system/timers.h"
+
+using namespace ImGui;
+using namespace std;
+
+static string formatBytes(uint64_t bytes) {
+	char buf[32];
+	if (bytes >= 1024ull * 1024ull)
+		snprintf(buf, sizeof(buf), "%.1f MB", bytes / (1024.0 * 1024.0));
+	else if (bytes >= 1024ull)
+		snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024.0);
+	else
+		snprintf(buf, sizeof(buf), "%llu B", static_cast<unsigned long long>(bytes));
+	return buf;
+}
+
+static vector<Diagnostics::DecodeBenchmarkRow> s_decodeBenchmark;
+static bool s_decodeBenchmarkRunning = false;
+
+static const char *laneName(size_t lane) {
+	return lane == static_cast<size_t>(Threading::Lane::Interactive) ? "interactive" : "background";
+}
+
+static string formatStatuses(const map<int, uint64_t> &statuses) {
+	string out;
+	for (const auto &[code, n]: statuses) {
+		if (!out.empty())
+			out += "  ";
+		out += (code == 0 ? string("err") : to_string(code)) + "x" + to_string(n);
+	}
+	return out;
+}
+
+namespace Diagnostics {
+	string DumpJson() {
+		using nlohmann::json;
+		json j = HttpClient::HttpMetrics::instance().toJson();
+		j["transport"] = HttpClient::transport()->name();
+		j["ioLoopInFlight"] = HttpClient::IoLoop::instance().inFlight();
+
+		auto pool = HttpClient::ConnectionPool::instance().stats();
+		j["pool"] = {
+			{"hits", pool.hits}, {"newConnections", pool.newConnections},
+			{"idleEvictions", pool.idleEvictions}, {"idle", pool.idle}
+		};
+
+		json limiter = json::object();
+		for (const auto &[family, s]: HttpClient::RateLimiter::instance().snapshot())
+			limiter[family] = {{"rps", s.requestsPerSecond}, {"queued", s.queued}, {"throttled", s.throttled}};
+		j["rateLimiter"] = limiter;
+
+		j["cache"] = {
+			{"hits", HttpClient::HttpCache::instance().hits()},
+			{"misses", HttpClient::HttpCache::instance().misses()}
+		};
+		j["coalesced"] = {
+			{"responses", HttpClient::responseFlights().coalesced()},
+			{"json", HttpClient::jsonFlights().coalesced()}
+		};
+		auto refresh = AccountRefresh::LastStats();
+		j["accountRefresh"] = {
+			{"accounts", refresh.accounts}, {"parallelism", refresh.parallelism}, {"totalMs", refresh.totalMs},
+			{"moderationMs", refresh.moderationMs}, {"profileMs", refresh.profileMs},
+			{"voiceMs", refresh.voiceMs}, {"presenceMs", refresh.presenceMs}
+		};
+		json decoders = json::array();
+		for (const auto &row: s_decodeBenchmark) {
+			decoders.push_back({
+				{"name", row.name}, {"bytes", row.bytes}, {"items", row.items}, {"iterations", row.iterations},
+				{"domMs", row.domMs}, {"saxMs", row.saxMs}
+			});
+		}
+		j["decodeBenchmark"] = decoders;
+
+		auto threads = Threading::ThreadPool::instance().stats();
+		json lanes = json::object();
+		for (size_t l = 0; l < threads.lanes.size(); ++l) {
+			const auto &lane = threads.lanes[l];
+			lanes[laneName(l)] = {
+				{"queued", lane.queued}, {"completed", lane.completed}, {"waitP50Ms", lane.waitP50Ms},
+				{"waitP95Ms", lane.waitP95Ms}, {"runP95Ms", lane.runP95Ms}
+			};
+		}
+		auto ui = MainThread::LastStats();
+		j["mainThread"] = {
+			{"backlog", ui.backlog}, {"lastRan", ui.lastRan}, {"lastLeftOver", ui.lastLeftOver},
+			{"lastMs", ui.lastMs}, {"budgetMs", g_mainThreadBudgetMs}
+		};
+		j["threadPool"] = {
+			{"workers", threads.workers}, {"coreWorkers", threads.coreWorkers}, {"busy", threads.busy},
+			{"lanes", lanes}
+		};
+		j["timersPending"] = Timers::TimerService::instance().pending();
+		return j.dump(2);
+	}
+
+	void RenderDiagnosticsTab() {
+		auto &metrics = HttpClient::HttpMetrics::instance();
+		auto endpoints = metrics.snapshot();
+
+		Text("Transport: %s", HttpClient::transport()->name());
+		SameLine();
+		Text("  In flight: %zu", metrics.inFlight());
+		SameLine();
+		Text("  Queued: %zu", HttpClient::RateLimiter::instance().queueDepth());
+
+		if (Button("Copy JSON"))
+			SetClipboardText(DumpJson().c_str());
+		SameLine();
+		if (Button("Save JSON")) {
+			string path = Data::StorageFilePath("diagnostics.json");
+			ofstream out(path, ios::trunc);
+			if (out.is_open()) {
+				out << DumpJson();
+				LOG_INFO("Diagnostics written to " + path);
+			} else {
+				LOG_ERROR("Failed to write " + path);
+			}
+		}
+		SameLine();
+		if (Button("Reset"))
+			metrics.reset();
+
+		SeparatorText("Endpoints");
+		ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable |
+		                        ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingStretchProp;
+		float tableHeight = max(GetContentRegionAvail().y - GetTextLineHeightWithSpacing() * 16.0f, 120.0f);
+		if (BeginTable("DiagnosticsEndpoints", 9, flags, ImVec2(0, tableHeight))) {
+			TableSetupScrollFreeze(0, 1);
+			TableSetupColumn("Endpoint", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+			TableSetupColumn("Reqs");
+			TableSetupColumn("p50 ms");
+			TableSetupColumn("p95 ms");
+			TableSetupColumn("p99 ms");
+			TableSetupColumn("Retries");
+			TableSetupColumn("In");
+			TableSetupColumn("Out");
+			TableSetupColumn("Statuses", ImGuiTableColumnFlags_WidthStretch, 2.0f);
+			TableHeadersRow();
+
+			for (const auto &[family, m]: endpoints) {
+				TableNextRow();
+				TableNextColumn();
+				TextUnformatted(family.c_str());
+				TableNextColumn();
+				Text("%llu", static_cast<unsigned long long>(m.requests));
+				TableNextColumn();
+				Text("%.0f", m.latency.percentile(0.50));
+				TableNextColumn();
+				Text("%.0f", m.latency.percentile(0.95));
+				TableNextColumn();
+				Text("%.0f", m.latency.percentile(0.99));
+				TableNextColumn();
+				Text("%llu", static_cast<unsigned long long>(m.retries));
+				TableNextColumn();
+				TextUnformatted(formatBytes(m.bytesIn).c_str());
+				TableNextColumn();
+				TextUnformatted(formatBytes(m.bytesOut).c_str());
+				TableNextColumn();
+				TextUnformatted(formatStatuses(m.statuses).c_str());
+			}
+			EndTable();
+		}
+
+		SeparatorText("Client");
+		auto pool = HttpClient::ConnectionPool::instance().stats();
+		Text("Connections: %llu reused, %llu new, %llu evicted, %zu idle",
+		     static_cast<unsigned long long>(pool.hits), static_cast<unsigned long long>(pool.newConnections),
+		     static_cast<unsigned long long>(pool.idleEvictions), pool.idle);
+		Text("Cache: %llu hits, %llu misses",
+		     static_cast<unsigned long long>(HttpClient::HttpCache::instance().hits()),
+		     static_cast<unsigned long long>(HttpClient::HttpCache::instance().misses()));
+		Text("Coalesced: %llu responses, %llu documents",
+		     static_cast<unsigned long long>(HttpClient::responseFlights().coalesced()),
+		     static_cast<unsigned long long>(HttpClient::jsonFlights().coalesced()));
+		auto refresh = AccountRefresh::LastStats();
+		Text("Account refresh: %zu accounts in %.0f ms (x%d) - moderation %.0f, profile %.0f, voice %.0f, "
+		     "presence %.0f ms", refresh.accounts, refresh.totalMs, refresh.parallelism, refresh.moderationMs,
+		     refresh.profileMs, refresh.voiceMs, refresh.presenceMs);
+
+		SeparatorText("Threads");
+		auto ui = MainThread::LastStats();
+		Text("UI queue: %zu waiting - last frame ran %zu in %.1f ms (budget %d ms), %zu carried over",
+		     ui.backlog, ui.lastRan, ui.lastMs, g_mainThreadBudgetMs, ui.lastLeftOver);
+		auto threads = Threading::ThreadPool::instance().stats();
+		Text("Workers: %zu (%zu core), %zu busy - timers pending: %zu", threads.workers, threads.coreWorkers,
+		     threads.busy, Timers::TimerService::instance().pending());
+		for (size_t l = 0; l < threads.lanes.size(); ++l) {
+			const auto &lane = threads.lanes[l];
+			Text("%s: %zu queued, %llu done - wait p50 %.0f / p95 %.0f ms, run p95 %.0f ms",
+			     l == 0 ? "Interactive" : "Background", lane.queued,
+			     static_cast<unsigned long long>(lane.completed), lane.waitP50Ms, lane.waitP95Ms, lane.runP95Ms);
+		}
+
+		BeginDisabled(s_decodeBenchmarkRunning);
+		if (Button(s_decodeBenchmarkRunning ? "Benchmarking..." : "Benchmark JSON Decoders")) {
+			s_decodeBenchmarkRunning = true;
+			Threading::newThread([] {
+				auto rows = RunDecodeBenchmark();
+				MainThread::Post([rows = std::move(rows)]() mutable {
+					s_decodeBenchmark = std::move(rows);
+					s_decodeBenchmarkRunning = false;
+				});
+			});
+		}
+		EndDisabled();
+		for (const auto &row: s_decodeBenchmark) {
+			Text("%s (%zu items, %s): DOM %.2f ms, SAX %.2f ms", row.name.c_str(), row.items,
+			     formatBytes(row.bytes).c_str(), row.domMs, row.saxMs);
+		}
+	}
+}
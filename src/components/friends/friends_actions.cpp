@@ -1,9 +1,13 @@
 #include "friends_actions.h"
 #include "network/roblox.h"
 #include "core/status.h"
+#include "system/main_thread.h"
+#include "system/threading.h"
 #include <algorithm>
+#include <chrono>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace std;
@@ -24,43 +28,70 @@ namespace FriendsActions {
         const string &userId,
         const string &cookie,
         vector<FriendInfo> &outFriendsList,
-        atomic<bool> &loadingFlag) {
+        atomic<bool> &loadingFlag,
+        HttpClient::CancelToken cancel) {
+        // A cancelled run (account switched away) leaves the output and the
+        // loading flag to whichever refresh replaced it. A failed or timed out
+        // run keeps the stored lists as they were, so missing pages are never
+        // mistaken for unfriends. Results are published on the main thread,
+        // re-checking the token there, so a run cancelled after its last check
+        // here still never writes into the next account's list.
+        HttpClient::RequestScope scope(cancel, chrono::seconds(30));
+        auto ctx = HttpClient::currentRequestContext();
+        auto stopLoading = [&] {
+            MainThread::Post([cancel, &loadingFlag] {
+                if (!cancel.cancelled())
+                    loadingFlag = false;
+            });
+        };
+        auto gaveUp = [&] {
+            if (cancel.cancelled())
+                return true;
+            if (!ctx.expired())
+                return false;
+            LOG_ERROR("Friends list refresh timed out");
+            stopLoading();
+            return true;
+        };
         loadingFlag = true;
         LOG_INFO("Fetching friends list...");
 
-        auto list = Roblox::getFriends(userId, cookie);
+        auto fetched = Roblox::getFriends(userId, cookie);
+        if (gaveUp())
+            return;
+        if (!fetched) {
+            LOG_ERROR("Friends list refresh failed; keeping the stored list");
+            stopLoading();
+            return;
+        }
+        vector<FriendInfo> list = move(*fetched);
 
+        // userId -> slot in `list`, so merging presences stays linear.
         vector<uint64_t> ids;
+        unordered_map<uint64_t, size_t> slotById;
         ids.reserve(list.size());
-        for (const auto &f: list) {
-            ids.push_back(f.id);
-        }
-
-        for (auto &f: list) {
-            f.presence = "Offline";
+        slotById.reserve(list.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            list[i].presence = "Offline";
+            ids.push_back(list[i].id);
+            slotById.emplace(list[i].id, i);
         }
 
         LOG_INFO("Fetching friend presences...");
 
-        for (size_t i = 0; i < ids.size(); i += 100) {
-            size_t batchEnd = (min)(ids.size(), i + 100);
-            vector batch_ids(ids.begin() + i, ids.begin() + batchEnd);
+        auto presMap = Roblox::getPresencesBatched(ids, cookie);
+        if (gaveUp())
+            return;
 
-            if (batch_ids.empty())
-                continue;
+        for (auto &[uid, pdata]: presMap) {
+            auto slot = slotById.find(uid);
+            if (slot == slotById.end()) continue;
 
-            auto presMap = Roblox::getPresences(batch_ids, cookie);
-
-            for (const auto &[uid, pdata]: presMap) {
-                auto it = find_if(list.begin(), list.end(),
-                                  [&](const FriendInfo &f) { return f.id == uid; });
-                if (it == list.end()) continue;
-
-                it->presence = pdata.presence;
-                it->lastLocation = pdata.lastLocation;
-                it->placeId = pdata.placeId;
-                it->jobId = pdata.jobId;
-            }
+            FriendInfo &f = list[slot->second];
+            f.presence = move(pdata.presence);
+            f.lastLocation = move(pdata.lastLocation);
+            f.placeId = pdata.placeId;
+            f.jobId = move(pdata.jobId);
         }
 
         sort(list.begin(), list.end(),
@@ -96,62 +127,89 @@ namespace FriendsActions {
                  return nameA_ref < nameB_ref;
              });
 
-        outFriendsList = move(list);
-
-        // Build set of current friend IDs for quick membership checks
-        unordered_set<uint64_t> newIds;
-        for (const auto &f : outFriendsList) newIds.insert(f.id);
-
-        // Detect newly lost friends by diffing previous cache vs current
-        vector<FriendInfo> unfriended;
-        auto itOld = g_accountFriends.find(accountId);
-        if (itOld != g_accountFriends.end()) {
-            for (const auto &oldF : itOld->second) {
-                if (newIds.find(oldF.id) == newIds.end())
-                    unfriended.push_back(oldF);
+        if (gaveUp())
+            return;
+
+        MainThread::Post([accountId, cancel, list = move(list), &outFriendsList, &loadingFlag]() mutable {
+            if (cancel.cancelled())
+                return;
+            outFriendsList = move(list);
+
+            // Build set of current friend IDs for quick membership checks
+            unordered_set<uint64_t> newIds;
+            for (const auto &f : outFriendsList) newIds.insert(f.id);
+
+            // Detect newly lost friends by diffing previous cache vs current
+            vector<FriendInfo> unfriended;
+            auto itOld = g_accountFriends.find(accountId);
+            if (itOld != g_accountFriends.end()) {
+                for (const auto &oldF : itOld->second) {
+                    if (newIds.find(oldF.id) == newIds.end())
+                        unfriended.push_back(oldF);
+                }
             }
-        }
 
-        // Update current friends cache
-        g_accountFriends[accountId] = outFriendsList;
-
-        // Merge newly detected unfriended, ensure container exists
-        auto &stored = g_unfriendedFriends[accountId];
-        std::unordered_set<uint64_t> seen;
-        for (const auto &f : stored) seen.insert(f.id);
-        for (const auto &f : unfriended) {
-            if (seen.find(f.id) == seen.end()) {
-                stored.push_back(f);
-                seen.insert(f.id);
+            // Update current friends cache
+            g_accountFriends[accountId] = outFriendsList;
+
+            // Merge newly detected unfriended, ensure container exists
+            auto &stored = g_unfriendedFriends[accountId];
+            std::unordered_set<uint64_t> seen;
+            for (const auto &f : stored) seen.insert(f.id);
+            for (const auto &f : unfriended) {
+                if (seen.find(f.id) == seen.end()) {
+                    stored.push_back(f);
+                    seen.insert(f.id);
+                }
             }
-        }
 
-        // Validation: remove any unfriended that are now friends and dedupe
-        if (!stored.empty()) {
-            stored.erase(remove_if(stored.begin(), stored.end(), [&](const FriendInfo &fi) {
-                               return newIds.find(fi.id) != newIds.end();
-                           }),
-                         stored.end());
-            std::vector<FriendInfo> dedup;
-            dedup.reserve(stored.size());
-            seen.clear();
-            for (auto &u : stored) if (seen.insert(u.id).second) dedup.push_back(std::move(u));
-            stored.swap(dedup);
-        }
-        Data::SaveFriends();
-        loadingFlag = false;
-        LOG_INFO("Friends list updated.");
+            // Validation: remove any unfriended that are now friends and dedupe
+            if (!stored.empty()) {
+                stored.erase(remove_if(stored.begin(), stored.end(), [&](const FriendInfo &fi) {
+                                   return newIds.find(fi.id) != newIds.end();
+                               }),
+                             stored.end());
+                std::vector<FriendInfo> dedup;
+                dedup.reserve(stored.size());
+                seen.clear();
+                for (auto &u : stored) if (seen.insert(u.id).second) dedup.push_back(std::move(u));
+                stored.swap(dedup);
+            }
+            Data::SaveFriends();
+            loadingFlag = false;
+            LOG_INFO("Friends list updated.");
+        });
     }
 
     void FetchFriendDetails(
-        const string &friendId,
+        uint64_t friendId,
         const string &cookie,
         Roblox::FriendDetail &outFriendDetail,
         atomic<bool> &loadingFlag) {
+        outFriendDetail = {};
+        outFriendDetail.id = friendId;
         loadingFlag = true;
         LOG_INFO("Fetching friend details...");
-        outFriendDetail = Roblox::getUserDetails(friendId, cookie);
-        loadingFlag = false;
-        LOG_INFO("Friend details loaded.");
+        // canUseCookie may have to ask Roblox, so it stays off the main thread.
+        Threading::newThread([friendId, cookie, &outFriendDetail, &loadingFlag] {
+            if (!Roblox::canUseCookie(cookie)) {
+                MainThread::Post([friendId, &outFriendDetail, &loadingFlag] {
+                    if (outFriendDetail.id == friendId)
+                        loadingFlag = false;
+                });
+                return;
+            }
+            Roblox::profileService().fetch(friendId, [friendId, &outFriendDetail, &loadingFlag](const Roblox::FriendDetail &d) {
+                MainThread::Post([friendId, d, &outFriendDetail, &loadingFlag] {
+                    if (outFriendDetail.id != friendId)
+                        return; // another user was selected meanwhile
+                    outFriendDetail = d;
+                    if (d.loaded & Roblox::ProfileUser)
+                        loadingFlag = false;
+                    if (d.loaded == Roblox::ProfileAll)
+                        LOG_INFO("Friend details loaded.");
+                });
+            });
+        });
     }
 }
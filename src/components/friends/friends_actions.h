@@ -13,10 +13,13 @@ namespace FriendsActions {
 		const std::string &userId,
 		const std::string &cookie,
 		std::vector<FriendInfo> &outFriendsList,
-		std::atomic<bool> &loadingFlag);
+		std::atomic<bool> &loadingFlag,
+		HttpClient::CancelToken cancel = {});
 
+	// Call on the main thread; returns right away. outFriendDetail.id is set
+	// immediately and the rest is filled in, part by part, on the main thread.
 	void FetchFriendDetails(
-		const std::string &friendId,
+		uint64_t friendId,
 		const std::string &cookie,
 		Roblox::FriendDetail &outFriendDetail,
 		std::atomic<bool> &loadingFlag);
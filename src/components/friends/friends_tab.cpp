@@ -38,6 +38,8 @@ static atomic<bool> g_friendsLoading{false};
 static vector<FriendInfo> g_unfriended;
 
 static int g_lastAcctIdForFriends = -1;
+// Owned by the friends list refresh of the account currently shown.
+static HttpClient::CancelToken g_friendsCancel = HttpClient::CancelToken::create();
 
 // Account whose friends list is currently being viewed. Defaults to the first
 // selected account but can be changed via the UI combo box.
@@ -204,6 +206,8 @@ void RenderFriendsTab()
 
     if (currentAcctId != g_lastAcctIdForFriends)
     {
+        g_friendsCancel.cancel();
+        g_friendsCancel = HttpClient::CancelToken::create();
         g_friends.clear();
         g_selectedFriendIdx = -1;
         g_selectedFriend = {};
@@ -225,7 +229,7 @@ void RenderFriendsTab()
         {
             Threading::newThread(FriendsActions::RefreshFullFriendsList, acct.id, acct.userId, acct.cookie,
                                  ref(g_friends),
-                                 ref(g_friendsLoading));
+                                 ref(g_friendsLoading), g_friendsCancel);
             if (g_friendsViewMode == 1)
                 LoadIncomingRequests(acct.cookie, true);
         }
@@ -322,7 +326,7 @@ void RenderFriendsTab()
         g_selectedFriend = {};
         if (g_friendsViewMode == 0) {
             Threading::newThread(FriendsActions::RefreshFullFriendsList, acct.id, acct.userId, acct.cookie, ref(g_friends),
-                                 ref(g_friendsLoading));
+                                 ref(g_friendsLoading), g_friendsCancel);
         } else {
             LoadIncomingRequests(acct.cookie, true);
         }
@@ -390,8 +394,11 @@ void RenderFriendsTab()
                                  {
                 try {
                     int sent = 0;
-                    for (const auto &sp : specs) {
-                        uint64_t uid = sp.isId ? sp.id : Roblox::getUserIdFromUsername(sp.username);
+                    // All usernames are resolved up front in batched lookups.
+                    auto ids = Roblox::resolveUserIds(specs);
+                    for (uint64_t uid : ids) {
+                        if (uid == 0)
+                            continue;
                         string resp;
                         bool ok = Roblox::sendFriendRequest(to_string(uid), cookie, &resp);
                         if (ok) {
@@ -498,12 +505,8 @@ void RenderFriendsTab()
                 if (clicked) {
                     g_selectedRequestIdx = static_cast<int>(i);
                     if (g_selectedRequestDetail.id != r.userId) {
-                        g_selectedRequestDetail = {};
-                        Threading::newThread(FriendsActions::FetchFriendDetails,
-                                             to_string(r.userId),
-                                             acct.cookie,
-                                             ref(g_selectedRequestDetail),
-                                             ref(g_requestDetailsLoading));
+                        FriendsActions::FetchFriendDetails(r.userId, acct.cookie, g_selectedRequestDetail,
+                                                           g_requestDetailsLoading);
                     }
                 }
 
@@ -586,7 +589,8 @@ void RenderFriendsTab()
                     Spacing();
                     Unindent(desiredTextIndent);
                 };
-                auto addRowInt = [&](const char *label, int v){ addRow(label, to_string(v)); };
+                // Counts still on their way show as "..." and failed ones as "?", rather than 0.
+                auto addRowInt = [&](const char *label, int v, unsigned part){ addRow(label, (D.failed & part) ? string("?") : (D.loaded & part) ? to_string(v) : string("...")); };
 
                 // 1. Display Name
                 addRow("Display Name:", !D.displayName.empty() ? D.displayName : (sel.displayName.empty()? sel.username : sel.displayName));
@@ -595,11 +599,11 @@ void RenderFriendsTab()
                 // 3. User ID
                 addRow("User ID:", to_string(D.id ? D.id : sel.userId));
                 // 4. Friends
-                if (D.friends) addRowInt("Friends:", D.friends);
+                if (D.friends || (D.failed & Roblox::ProfileFriends) || !(D.loaded & Roblox::ProfileFriends)) addRowInt("Friends:", D.friends, Roblox::ProfileFriends);
                 // 5. Followers
-                if (D.followers) addRowInt("Followers:", D.followers);
+                if (D.followers || (D.failed & Roblox::ProfileFollowers) || !(D.loaded & Roblox::ProfileFollowers)) addRowInt("Followers:", D.followers, Roblox::ProfileFollowers);
                 // 6. Following
-                if (D.following) addRowInt("Following:", D.following);
+                if (D.following || (D.failed & Roblox::ProfileFollowing) || !(D.loaded & Roblox::ProfileFollowing)) addRowInt("Following:", D.following, Roblox::ProfileFollowing);
                 // 7. Created
                 if (!D.createdIso.empty()) addRow("Created:", formatAbsoluteWithRelativeFromIso(D.createdIso));
                 // Request-only fields
@@ -851,12 +855,7 @@ void RenderFriendsTab()
                 g_selectedFriendIdx = static_cast<int>(i);
                 if (g_selectedFriend.id != f.id)
                 {
-                    g_selectedFriend = {};
-                    Threading::newThread(FriendsActions::FetchFriendDetails,
-                                         to_string(f.id),
-                                         acct.cookie,
-                                         ref(g_selectedFriend),
-                                         ref(g_friendDetailsLoading));
+                    FriendsActions::FetchFriendDetails(f.id, acct.cookie, g_selectedFriend, g_friendDetailsLoading);
                 }
             }
             PopID();
@@ -1033,9 +1032,11 @@ void RenderFriendsTab()
                     Unindent(desiredTextIndent);
                 };
 
-                auto addFriendDataRowInt = [&](const char *label, int value)
+                // Counts still on their way show as "..." and failed ones as "?", rather than 0.
+                auto addFriendDataRowInt = [&](const char *label, int value, unsigned part)
                 {
-                    addFriendDataRow(label, to_string(value));
+                    addFriendDataRow(label, (D.failed & part) ? string("?")
+                                            : (D.loaded & part) ? to_string(value) : string("..."));
                 };
 
                 // 1. Display Name
@@ -1045,11 +1046,11 @@ void RenderFriendsTab()
                 // 3. User ID
                 addFriendDataRow("User ID:", to_string(D.id));
                 // 4. Friends
-                addFriendDataRowInt("Friends:", D.friends);
+                addFriendDataRowInt("Friends:", D.friends, Roblox::ProfileFriends);
                 // 5. Followers
-                addFriendDataRowInt("Followers:", D.followers);
+                addFriendDataRowInt("Followers:", D.followers, Roblox::ProfileFollowers);
                 // 6. Following
-                addFriendDataRowInt("Following:", D.following);
+                addFriendDataRowInt("Following:", D.following, Roblox::ProfileFollowing);
                 // 7. Created
                 addFriendDataRow("Created:", formatAbsoluteWithRelativeFromIso(D.createdIso));
 
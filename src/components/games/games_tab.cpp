@@ -1,4 +1,6 @@
 #define _CRT_SECURE_NO_WARNINGS
+#include <cctype>
+#include <list>
 #include <unordered_map>
 #include <unordered_set>
 #include "games_utils.h"
@@ -7,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <chrono>
 #include <thread>
 #include <utility>
 
@@ -15,6 +18,8 @@
 #include "system/launcher.hpp"
 #include "network/roblox.h"
 #include "core/status.h"
+#include "system/main_thread.h"
+#include "system/threading.h"
 #include "ui/webview.hpp"
 #include "ui/modal_popup.h"
 #include "../../ui.h"
@@ -35,6 +40,30 @@ static int selectedIndex = -1;
 static vector<GameInfo> gamesList;
 static vector<GameInfo> originalGamesList;
 static unordered_map<uint64_t, Roblox::GameDetail> gameDetailCache;
+// Universes already asked for, so a failed lookup isn't retried every frame.
+static unordered_set<uint64_t> gameDetailRequested;
+static bool gameDetailsLoading = false;
+static chrono::steady_clock::time_point lastPlayerCountRefresh{};
+static constexpr auto kPlayerCountRefreshInterval = chrono::seconds(60);
+
+// Search results per normalized query, most recently used first, so going
+// back to or refining a recent search shows results without waiting.
+struct SearchResults {
+    string sessionId;
+    vector<GameInfo> games;
+    string nextPageToken; // empty once the last page is in
+};
+static constexpr size_t kSearchCacheSize = 32;
+static constexpr auto kSearchDebounce = chrono::milliseconds(350);
+static constexpr auto kSearchTimeout = chrono::seconds(15);
+static list<pair<string, SearchResults> > searchCache;
+static unordered_map<string, list<pair<string, SearchResults> >::iterator> searchCacheIndex;
+static string activeQuery; // normalized query the result list belongs to
+static bool searchLoading = false;
+static bool searchMoreFailed = false; // next page of activeQuery failed; retried by hand
+static bool searchEdited = false;
+static chrono::steady_clock::time_point searchEditedAt{};
+static HttpClient::CancelToken searchCancel;
 
 static unordered_set<uint64_t> favoriteGameIds;
 static auto ICON_OPEN_LINK = "\xEF\x8A\xBB ";
@@ -67,6 +96,50 @@ static void RenderSearchResultsList(float listWidth, float availableHeight);
 
 static void RenderGameDetailsPanel(float panelWidth, float availableHeight);
 
+static void applyPlayerCount(vector<GameInfo> &list, uint64_t universeId, int playing) {
+    for (auto &g: list) {
+        if (g.universeId == universeId)
+            g.playerCount = playing;
+    }
+}
+
+// Fetches details for every favorite and search result in a few batched
+// requests on a worker thread. `live` re-reads everything listed, bypassing
+// the response cache, to refresh player counts.
+static void requestGameDetails(bool live) {
+    if (gameDetailsLoading)
+        return;
+    vector<uint64_t> ids;
+    auto want = [&](uint64_t id) {
+        if (id == 0)
+            return;
+        if (gameDetailRequested.insert(id).second || live)
+            ids.push_back(id);
+    };
+    for (const auto &g: favoriteGamesList)
+        want(g.universeId);
+    for (const auto &g: originalGamesList)
+        want(g.universeId);
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    if (ids.empty())
+        return;
+
+    gameDetailsLoading = true;
+    Threading::submit(live ? Threading::Lane::Background : Threading::Lane::Interactive, [ids, live] {
+        auto details = Roblox::getGameDetails(ids, live);
+        MainThread::Post([details = std::move(details)]() mutable {
+            gameDetailsLoading = false;
+            for (auto &[id, detail]: details) {
+                applyPlayerCount(favoriteGamesList, id, detail.playing);
+                applyPlayerCount(originalGamesList, id, detail.playing);
+                applyPlayerCount(gamesList, id, detail.playing);
+                gameDetailCache[id] = std::move(detail);
+            }
+        });
+    });
+}
+
 static void SortGamesList() {
     gamesList = originalGamesList;
 
@@ -97,6 +170,141 @@ static void SortGamesList() {
     }
 }
 
+static string normalizeQuery(const char *text) {
+    string q(text);
+    size_t first = q.find_first_not_of(" \t");
+    if (first == string::npos)
+        return {};
+    q = q.substr(first, q.find_last_not_of(" \t") - first + 1);
+    transform(q.begin(), q.end(), q.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+    return q;
+}
+
+static SearchResults *findCachedSearch(const string &query) {
+    auto it = searchCacheIndex.find(query);
+    if (it == searchCacheIndex.end())
+        return nullptr;
+    searchCache.splice(searchCache.begin(), searchCache, it->second);
+    return &it->second->second;
+}
+
+static void storeCachedSearch(const string &query, SearchResults results) {
+    if (auto *existing = findCachedSearch(query)) {
+        *existing = std::move(results);
+        return;
+    }
+    searchCache.emplace_front(query, std::move(results));
+    searchCacheIndex[query] = searchCache.begin();
+    if (searchCache.size() > kSearchCacheSize) {
+        searchCacheIndex.erase(searchCache.back().first);
+        searchCache.pop_back();
+    }
+}
+
+// Replaces the result list, keeping the selected game selected.
+static void showSearchResults(const vector<GameInfo> &games) {
+    uint64_t selectedUniverse = 0;
+    if (selectedIndex >= 0 && selectedIndex < static_cast<int>(gamesList.size()))
+        selectedUniverse = gamesList[selectedIndex].universeId;
+
+    originalGamesList = games;
+    erase_if_local(originalGamesList, [&](const GameInfo &g) {
+        return favoriteGameIds.count(g.universeId) != 0;
+    });
+    SortGamesList();
+
+    if (selectedIndex >= 0) {
+        selectedIndex = -1;
+        for (int i = 0; i < static_cast<int>(gamesList.size()); ++i) {
+            if (gamesList[i].universeId == selectedUniverse && selectedUniverse != 0)
+                selectedIndex = i;
+        }
+    }
+}
+
+// Runs a search (or fetches its next page) on a worker thread. A new query
+// cancels whatever search was still running.
+static void startSearch(const string &query, bool nextPage) {
+    if (query.empty())
+        return;
+
+    string sessionId;
+    string pageToken;
+    if (nextPage) {
+        SearchResults *cached = findCachedSearch(query);
+        if (!cached || cached->nextPageToken.empty() || searchLoading)
+            return;
+        sessionId = cached->sessionId;
+        pageToken = cached->nextPageToken;
+    } else {
+        searchCancel.cancel();
+        searchLoading = false;
+        searchMoreFailed = false;
+        if (query != activeQuery)
+            selectedIndex = -1;
+        activeQuery = query;
+        if (SearchResults *cached = findCachedSearch(query)) {
+            showSearchResults(cached->games);
+            return;
+        }
+        // While the request runs, narrow the closest earlier search instead
+        // of showing nothing.
+        const SearchResults *closest = nullptr;
+        size_t closestLen = 0;
+        for (const auto &[cachedQuery, results]: searchCache) {
+            if (cachedQuery.size() > closestLen && query.compare(0, cachedQuery.size(), cachedQuery) == 0) {
+                closest = &results;
+                closestLen = cachedQuery.size();
+            }
+        }
+        if (closest) {
+            vector<GameInfo> narrowed;
+            for (const auto &g: closest->games) {
+                if (containsCI(g.name, query))
+                    narrowed.push_back(g);
+            }
+            showSearchResults(narrowed);
+        }
+        sessionId = generateSessionId();
+    }
+
+    searchCancel = HttpClient::CancelToken::create();
+    searchLoading = true;
+    Threading::newThread([query, sessionId, pageToken, nextPage, token = searchCancel] {
+        HttpClient::RequestScope scope(token, kSearchTimeout);
+        auto page = Roblox::searchGamesPage(query, sessionId, pageToken);
+        MainThread::Post([query, sessionId, nextPage, token, page = std::move(page)]() mutable {
+            if (token.cancelled())
+                return;
+            searchLoading = false;
+            if (!page.ok) {
+                // Stops the list end from asking again every frame.
+                if (nextPage && query == activeQuery)
+                    searchMoreFailed = true;
+                return;
+            }
+
+            SearchResults results;
+            if (nextPage) {
+                if (SearchResults *cached = findCachedSearch(query))
+                    results = std::move(*cached);
+            }
+            unordered_set<uint64_t> seen;
+            for (const auto &g: results.games)
+                seen.insert(g.universeId);
+            for (auto &g: page.games) {
+                if (seen.insert(g.universeId).second)
+                    results.games.push_back(std::move(g));
+            }
+            results.sessionId = sessionId;
+            results.nextPageToken = std::move(page.nextPageToken);
+            if (query == activeQuery)
+                showSearchResults(results.games);
+            storeCachedSearch(query, std::move(results));
+        });
+    });
+}
+
 static void RenderGameSearch() {
     ImGuiStyle &style = GetStyle();
     const char *sortOptions[] = {
@@ -116,25 +324,36 @@ static void RenderGameSearch() {
     if (inputWidth < minField)
         inputWidth = minField;
     PushItemWidth(inputWidth);
-    InputTextWithHint("##game_search", "Search games", searchBuffer, sizeof(searchBuffer));
+    if (InputTextWithHint("##game_search", "Search games", searchBuffer, sizeof(searchBuffer))) {
+        searchEdited = true;
+        searchEditedAt = chrono::steady_clock::now();
+    }
     PopItemWidth();
     SameLine(0, style.ItemSpacing.x);
     if (Button(" \xEF\x80\x82  Search ", ImVec2(searchButtonWidth, 0)) && searchBuffer[0] != '\0') {
-        selectedIndex = -1;
-        originalGamesList = Roblox::searchGames(searchBuffer);
-        erase_if_local(originalGamesList, [&](const GameInfo &g) {
-            return favoriteGameIds.count(g.universeId) != 0;
-        });
-        SortGamesList();
-        gameDetailCache.clear();
+        searchEdited = false;
+        startSearch(normalizeQuery(searchBuffer), false);
+    }
+    // Typing searches by itself once the text has settled.
+    if (searchEdited && chrono::steady_clock::now() - searchEditedAt >= kSearchDebounce) {
+        searchEdited = false;
+        string query = normalizeQuery(searchBuffer);
+        if (!query.empty() && query != activeQuery)
+            startSearch(query, false);
     }
     SameLine(0, style.ItemSpacing.x);
     if (Button(" \xEF\x87\xB8  Clear ", ImVec2(clearButtonWidth, 0))) {
+        searchCancel.cancel();
+        searchLoading = false;
+        searchMoreFailed = false;
+        searchEdited = false;
+        activeQuery.clear();
         searchBuffer[0] = '\0';
         selectedIndex = -1;
         originalGamesList.clear();
         gamesList.clear();
         gameDetailCache.clear();
+        gameDetailRequested.clear();
     }
     SameLine(0, style.ItemSpacing.x);
     PushItemWidth(comboWidth);
@@ -288,6 +507,29 @@ static void RenderSearchResultsList(float listWidth, float availableHeight) {
         }
         PopID();
     }
+
+    // Infinite scroll: the next page is fetched once the end of the list shows.
+    if (activeQuery.empty())
+        return;
+    if (searchLoading) {
+        TextDisabled("Searching...");
+    } else {
+        auto it = searchCacheIndex.find(activeQuery);
+        if (it != searchCacheIndex.end() && !it->second->second.nextPageToken.empty()) {
+            if (searchMoreFailed) {
+                TextDisabled("Couldn't load more results.");
+                SameLine();
+                if (SmallButton("Retry")) {
+                    searchMoreFailed = false;
+                    startSearch(activeQuery, true);
+                }
+            } else {
+                TextDisabled("Loading more...");
+                if (IsItemVisible())
+                    startSearch(activeQuery, true);
+            }
+        }
+    }
 }
 
 void RenderGamesTab() {
@@ -303,10 +545,20 @@ void RenderGamesTab() {
             favoriteGamesList.push_back(favoriteGameInfo);
         }
         hasLoadedFavorites = true;
+        lastPlayerCountRefresh = chrono::steady_clock::now();
     }
 
     RenderGameSearch();
 
+    // New rows get their details once; everything listed gets its player
+    // count re-read on a timer.
+    auto now = chrono::steady_clock::now();
+    if (!gameDetailsLoading && now - lastPlayerCountRefresh >= kPlayerCountRefreshInterval) {
+        lastPlayerCountRefresh = now;
+        requestGameDetails(true);
+    }
+    requestGameDetails(false);
+
     float availableHeight = GetContentRegionAvail().y;
     float availableWidth = GetContentRegionAvail().x;
     float minSide = GetFontSize() * 14.0f; // ~224px at 16px
@@ -353,16 +605,11 @@ static void RenderGameDetailsPanel(float panelWidth, float availableHeight) {
 
     if (currentGameInfo) {
         const GameInfo &gameInfo = *currentGameInfo;
+        // Filled in by requestGameDetails(); blank until the batch lands.
         Roblox::GameDetail detailInfo;
         auto cacheIterator = gameDetailCache.find(currentUniverseId);
-        if (cacheIterator == gameDetailCache.end()) {
-            if (currentUniverseId != 0) {
-                detailInfo = Roblox::getGameDetail(currentUniverseId);
-                gameDetailCache[currentUniverseId] = detailInfo;
-            }
-        } else {
+        if (cacheIterator != gameDetailCache.end())
             detailInfo = cacheIterator->second;
-        }
 
         int serverCount = detailInfo.maxPlayers > 0
                               ? static_cast<int>(
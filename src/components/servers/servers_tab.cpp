@@ -3,6 +3,7 @@
 #include "servers_utils.h"
 
 #include <array>
+#include <chrono>
 #include <vector>
 #include <string>
 #include <stdexcept>
@@ -13,11 +14,14 @@
 #include <cctype>
 #include <thread>
 #include <utility>
+#include <memory>
 #include <cstdio>
 
 #include "../components.h"
 #include "network/roblox.h"
 #include "core/status.h"
+#include "system/main_thread.h"
+#include "system/threading.h"
 #include "system/launcher.hpp"
 #include "ui/modal_popup.h"
 #include "../../ui.h"
@@ -52,6 +56,19 @@ static char s_placeIdBuffer[32]{};
 
 static uint64_t g_current_placeId_servers = 0;
 
+// Page fetches run off the UI thread; starting a new one cancels the last.
+static HttpClient::CancelToken g_serversCancel = HttpClient::CancelToken::create();
+static bool s_serversLoading = false;
+constexpr auto kServerPageTimeout = chrono::seconds(15);
+
+// "Crawl All" walks every page into one de-duplicated list; while it exists
+// the table shows its servers instead of the current page.
+static shared_ptr<Roblox::ServerCrawler> g_crawler;
+static uint64_t g_crawlVersion = 0;
+static bool g_crawlTargetReported = false;
+static char s_crawlJobBuffer[64]{};
+static int s_crawlMinFreeSlots = 0;
+
 static bool matchesQuery(const PublicServerInfo &srv, const string &qLower)
 {
     string hay = srv.jobId + ' ' + to_string(srv.currentPlayers) + '/' +
@@ -62,39 +79,142 @@ static bool matchesQuery(const PublicServerInfo &srv, const string &qLower)
     return lowerHay.find(qLower) != string::npos;
 }
 
-static void fetchPageServers(uint64_t placeId, const string &cursor = {})
+static void applyServerPage(const Roblox::ServerPage &page, const string &cursor)
 {
-    try
+    s_cachedServers = page.data;
+    g_nextCursor_servers = page.nextCursor;
+    g_prevCursor_servers = page.prevCursor;
+    g_currCursor_servers = cursor;
+    LOG_INFO(s_cachedServers.empty() ? "No servers found for this page" : "Fetched servers");
+}
+
+static void stopCrawl()
+{
+    if (g_crawler)
+        g_crawler->stop();
+    g_crawler.reset();
+}
+
+static void startCrawl(uint64_t placeId)
+{
+    stopCrawl();
+    g_serversCancel.cancel();
+    s_serversLoading = false;
+
+    Roblox::CrawlTarget target;
+    target.jobId = s_crawlJobBuffer;
+    erase_if(target.jobId, ::isspace);
+    target.minFreeSlots = s_crawlMinFreeSlots;
+
+    g_current_placeId_servers = placeId;
+    g_pageCache.clear();
+    s_cachedServers.clear();
+    g_nextCursor_servers.clear();
+    g_prevCursor_servers.clear();
+    g_currCursor_servers.clear();
+    g_crawlVersion = 0;
+    g_crawlTargetReported = false;
+    g_crawler = Roblox::ServerCrawler::start(placeId, move(target));
+}
+
+// Copies the crawler's servers into the table whenever it has new ones.
+static void pollCrawl()
+{
+    if (!g_crawler)
+        return;
+    uint64_t version = g_crawler->store().version();
+    if (version != g_crawlVersion)
     {
-        if (placeId != g_current_placeId_servers)
+        g_crawlVersion = version;
+        s_cachedServers = g_crawler->store().snapshot();
+    }
+    if (!g_crawlTargetReported)
+    {
+        if (auto found = g_crawler->found())
         {
-            g_pageCache.clear();
-            g_current_placeId_servers = placeId;
+            g_crawlTargetReported = true;
+            LOG_INFO("Found matching server " + found->jobId);
+            snprintf(s_searchBuffer, sizeof(s_searchBuffer), "%s", found->jobId.c_str());
         }
+    }
+}
+
+static bool parsePlaceIdInput(uint64_t &out)
+{
+    string raw_pid{s_placeIdBuffer};
+    erase_if(raw_pid, ::isspace);
+    if (raw_pid.empty() || !all_of(raw_pid.begin(), raw_pid.end(), ::isdigit))
+    {
+        LOG_INFO("Place ID must be all digits.");
+        return false;
+    }
+    try
+    {
+        out = stoull(raw_pid);
+        return true;
+    }
+    catch (const out_of_range &oor)
+    {
+        LOG_INFO(string("Place ID is too large: ") + oor.what());
+    }
+    catch (const invalid_argument &ia)
+    {
+        LOG_INFO(string("Invalid Place ID format: ") + ia.what());
+    }
+    return false;
+}
+
+static void fetchPageServers(uint64_t placeId, const string &cursor = {})
+{
+    stopCrawl();
+    // Whatever page was still loading is no longer wanted.
+    g_serversCancel.cancel();
+    g_serversCancel = HttpClient::CancelToken::create();
+    s_serversLoading = false;
+
+    if (placeId != g_current_placeId_servers)
+    {
+        g_pageCache.clear();
+        g_current_placeId_servers = placeId;
+    }
+    auto it_cache = g_pageCache.find(cursor);
+    if (it_cache != g_pageCache.end())
+    {
+        applyServerPage(it_cache->second, cursor);
+        return;
+    }
+
+    s_serversLoading = true;
+    Threading::newThread([placeId, cursor, token = g_serversCancel]
+    {
+        HttpClient::RequestScope scope(token, kServerPageTimeout);
         Roblox::ServerPage page;
-        auto it_cache = g_pageCache.find(cursor);
-        if (it_cache != g_pageCache.end())
+        string error;
+        try
         {
-            page = it_cache->second;
+            page = Roblox::getPublicServersPage(placeId, cursor);
         }
-        else
+        catch (const exception &ex)
         {
-            page = Roblox::getPublicServersPage(placeId, cursor);
-            g_pageCache.emplace(cursor, page);
+            error = ex.what();
         }
-        s_cachedServers = page.data;
-        g_nextCursor_servers = page.nextCursor;
-        g_prevCursor_servers = page.prevCursor;
-        g_currCursor_servers = cursor;
-        LOG_INFO(s_cachedServers.empty() ? "No servers found for this page" : "Fetched servers");
-    }
-    catch (const exception &ex)
-    {
-        LOG_INFO(string("Fetch error: ") + ex.what());
-        s_cachedServers.clear();
-        g_nextCursor_servers.clear();
-        g_prevCursor_servers.clear();
-    }
+        MainThread::Post([placeId, cursor, token, page = move(page), error = move(error)]() mutable
+        {
+            if (token.cancelled() || placeId != g_current_placeId_servers)
+                return;
+            s_serversLoading = false;
+            if (!error.empty())
+            {
+                LOG_INFO(string("Fetch error: ") + error);
+                s_cachedServers.clear();
+                g_nextCursor_servers.clear();
+                g_prevCursor_servers.clear();
+                return;
+            }
+            auto [it, inserted] = g_pageCache.emplace(cursor, move(page));
+            applyServerPage(it->second, cursor);
+        });
+    });
 }
 
 void ServerTab_SearchPlace(uint64_t placeId)
@@ -127,41 +247,55 @@ void RenderServersTab()
     SameLine(0, style.ItemSpacing.x);
     if (Button("Fetch Servers", ImVec2(fetchButtonWidth, 0)))
     {
-        string raw_pid{s_placeIdBuffer};
-        erase_if(raw_pid, ::isspace);
-        if (raw_pid.empty() || !all_of(raw_pid.begin(), raw_pid.end(), ::isdigit))
+        uint64_t pid_val = 0;
+        if (parsePlaceIdInput(pid_val))
         {
-            LOG_INFO("Place ID must be all digits.");
-        }
-        else
-        {
-            try
-            {
-                uint64_t pid_val = stoull(raw_pid);
-                g_currCursor_servers.clear();
-                fetchPageServers(pid_val);
-            }
-            catch (const out_of_range &oor)
-            {
-                LOG_INFO(string("Place ID is too large: ") + oor.what());
-            }
-            catch (const invalid_argument &ia)
-            {
-                LOG_INFO(string("Invalid Place ID format: ") + ia.what());
-            }
+            g_currCursor_servers.clear();
+            fetchPageServers(pid_val);
         }
     }
     SameLine(0, style.ItemSpacing.x);
-    BeginDisabled(g_prevCursor_servers.empty());
+    BeginDisabled(g_prevCursor_servers.empty() || s_serversLoading);
     if (Button("\xEF\x81\x93 Prev Page", ImVec2(prevButtonWidth, 0)))
         fetchPageServers(g_current_placeId_servers, g_prevCursor_servers);
     EndDisabled();
     SameLine(0, style.ItemSpacing.x);
-    BeginDisabled(g_nextCursor_servers.empty());
+    BeginDisabled(g_nextCursor_servers.empty() || s_serversLoading);
     if (Button("Next Page \xEF\x81\x94", ImVec2(nextButtonWidth, 0)))
         fetchPageServers(g_current_placeId_servers, g_nextCursor_servers);
     EndDisabled();
 
+    pollCrawl();
+    bool crawling = g_crawler && g_crawler->running();
+    if (crawling)
+    {
+        if (Button("Stop Crawl"))
+            g_crawler->stop();
+    }
+    else if (Button("Crawl All Pages"))
+    {
+        uint64_t pid_val = 0;
+        if (parsePlaceIdInput(pid_val))
+            startCrawl(pid_val);
+    }
+    SameLine(0, style.ItemSpacing.x);
+    BeginDisabled(crawling);
+    PushItemWidth(GetFontSize() * 14.0f);
+    InputTextWithHint("##crawl_job", "Stop at Job ID", s_crawlJobBuffer, sizeof(s_crawlJobBuffer));
+    PopItemWidth();
+    SameLine(0, style.ItemSpacing.x);
+    PushItemWidth(GetFontSize() * 6.0f);
+    if (InputInt("Min free slots", &s_crawlMinFreeSlots))
+        s_crawlMinFreeSlots = (max)(s_crawlMinFreeSlots, 0);
+    PopItemWidth();
+    EndDisabled();
+    if (g_crawler)
+    {
+        SameLine(0, style.ItemSpacing.x);
+        Text("%s%zu servers, %zu pages", crawling ? "Crawling... " : "", g_crawler->store().size(),
+             g_crawler->pages());
+    }
+
     Separator();
     const char *sortOptions[] = {
         "None",
@@ -189,7 +323,15 @@ void RenderServersTab()
     string qLower = toLower(s_searchBuffer);
     bool isSearching = !qLower.empty();
     vector<PublicServerInfo> displayList;
-    if (isSearching)
+    if (isSearching && g_crawler)
+    {
+        for (const auto &srv : s_cachedServers)
+        {
+            if (matchesQuery(srv, qLower))
+                displayList.push_back(srv);
+        }
+    }
+    else if (isSearching)
     {
         for (const auto &pair_cache : g_pageCache)
         {
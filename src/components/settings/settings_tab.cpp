@@ -1,5 +1,6 @@
 #include "settings.h"
 #include <imgui.h>
+#include <algorithm>
 #include <vector>
 #include <string>
 
@@ -8,18 +9,25 @@
 #include "core/app_state.h"
 #include "../../utils/system/multi_instance.h"
 #include "../console/console.h"
+#include "../diagnostics/diagnostics.h"
+#include "../accounts/account_refresh.h"
 
 using namespace ImGui;
 using namespace std;
 
 // Static flag to manage console modal visibility
 static bool g_requestOpenConsoleModal = false;
+static bool g_requestOpenDiagnosticsModal = false;
 
 void RenderSettingsTab() {
         // Button to open the Console modal (always visible)
         if (Button("Open Console")) {
                 g_requestOpenConsoleModal = true;
         }
+        SameLine();
+        if (Button("Open Diagnostics")) {
+                g_requestOpenDiagnosticsModal = true;
+        }
         Spacing();
 
         if (!g_accounts.empty()) {
@@ -76,7 +84,26 @@ void RenderSettingsTab() {
                                 interval = 1;
                         if (interval != g_statusRefreshInterval) {
                                 g_statusRefreshInterval = interval;
-                                Data::SaveSettings("settings.json");
+                                AccountRefresh::SetRefreshInterval(interval);
+                                Data::ScheduleSaveSettings();
+                        }
+                }
+
+                int parallelism = g_refreshParallelism;
+                if (InputInt("Parallel Account Refreshes", &parallelism)) {
+                        parallelism = clamp(parallelism, 1, 32);
+                        if (parallelism != g_refreshParallelism) {
+                                g_refreshParallelism = parallelism;
+                                Data::ScheduleSaveSettings();
+                        }
+                }
+
+                int budget = g_mainThreadBudgetMs;
+                if (InputInt("UI Work Budget per Frame (ms)", &budget)) {
+                        budget = clamp(budget, 1, 50);
+                        if (budget != g_mainThreadBudgetMs) {
+                                g_mainThreadBudgetMs = budget;
+                                Data::ScheduleSaveSettings();
                         }
                 }
 
@@ -112,6 +139,12 @@ void RenderSettingsTab() {
                         Data::SaveSettings("settings.json");
                 }
                 EndDisabled();
+
+                bool preMint = g_preMintAuthTickets;
+                if (Checkbox("Pre-mint Launch Tickets for Selected Accounts", &preMint)) {
+                        g_preMintAuthTickets = preMint;
+                        Data::SaveSettings("settings.json");
+                }
         } else {
                 TextDisabled("No accounts available to set a default.");
         }
@@ -152,4 +185,36 @@ void RenderSettingsTab() {
 
                 EndPopup();
         }
+
+        if (g_requestOpenDiagnosticsModal) {
+                OpenPopup("DiagnosticsPopup");
+                g_requestOpenDiagnosticsModal = false;
+        }
+
+        SetNextWindowSize(desiredSize, ImGuiCond_Always);
+
+        if (BeginPopupModal("DiagnosticsPopup", nullptr, ImGuiWindowFlags_NoResize)) {
+                ImGuiStyle &style = GetStyle();
+
+                float closeBtnWidth = CalcTextSize("Close").x + style.FramePadding.x * 2.0f;
+                float closeBtnHeight = GetFrameHeight();
+
+                ImVec2 avail = GetContentRegionAvail();
+                float childHeight = avail.y - closeBtnHeight - style.ItemSpacing.y;
+                if (childHeight < 0)
+                        childHeight = 0;
+
+                BeginChild("DiagnosticsArea", ImVec2(0, childHeight), ImGuiChildFlags_Borders);
+                Diagnostics::RenderDiagnosticsTab();
+                EndChild();
+
+                Spacing();
+
+                SetCursorPosX(GetContentRegionMax().x - closeBtnWidth);
+                if (Button("Close", ImVec2(closeBtnWidth, 0))) {
+                        CloseCurrentPopup();
+                }
+
+                EndPopup();
+        }
 }
@@ -18,11 +18,13 @@
 #include <objbase.h>
 
 #include "components/data.h"
+#include "components/accounts/account_refresh.h"
 #include "network/roblox.h"
 #include "ui/notifications.h"
 #include "core/logging.hpp"
 #include "ui/confirm.h"
 #include "system/main_thread.h"
+#include "system/threading.h"
 #include "system/update.h"
 #include <cstdio>
 #include <thread>
@@ -194,163 +196,14 @@ int WINAPI WinMain(
     }
 
     Data::LoadSettings("settings.json");
+    Roblox::configureTransportFromEnvironment();
     if (g_checkUpdatesOnStartup) {
         CheckForUpdates();
     }
     Data::LoadAccounts("accounts.json");
     Data::LoadFriends("friends.json");
 
-    auto refreshAccounts = [] {
-        std::vector<int> invalidIds;
-        std::string names;
-        for (auto &acct: g_accounts) {
-            if (acct.cookie.empty())
-                continue;
-            auto banInfo = Roblox::checkBanStatus(acct.cookie);
-            if (banInfo.status == Roblox::BanCheckResult::InvalidCookie) {
-                invalidIds.push_back(acct.id);
-                if (!names.empty())
-                    names += ", ";
-                names += acct.displayName.empty() ? acct.username : acct.displayName;
-            } else if (banInfo.status == Roblox::BanCheckResult::Banned) {
-                acct.status = "Banned";
-                acct.banExpiry = banInfo.endDate;
-                g_selectedAccountIds.erase(acct.id);
-            } else if (banInfo.status == Roblox::BanCheckResult::Warned) {
-                acct.status = "Warned";
-                acct.banExpiry = 0;
-                g_selectedAccountIds.erase(acct.id);  // Remove from selection like banned accounts
-            } else if (banInfo.status == Roblox::BanCheckResult::Terminated) {
-                acct.status = "Terminated";
-                acct.banExpiry = 0; // Terminated accounts don't have an end date
-                g_selectedAccountIds.erase(acct.id);
-            }
-        }
-        for (auto &acct: g_accounts) {
-            if (acct.cookie.empty() && acct.userId.empty())
-                continue;
-
-            bool needsUserInfoUpdate = true;
-            uint64_t uid = 0;
-
-            // Try cookie first - it's the most authoritative source
-            if (!acct.cookie.empty()) {
-                auto banInfo = Roblox::checkBanStatus(acct.cookie);
-                if (banInfo.status == Roblox::BanCheckResult::Banned) {
-                    acct.status = "Banned";
-                    acct.banExpiry = banInfo.endDate;
-                    acct.voiceStatus = "N/A";
-                    acct.voiceBanExpiry = 0;
-                    continue;
-                } else if (banInfo.status == Roblox::BanCheckResult::Warned) {
-                    acct.status = "Warned";
-                    acct.banExpiry = 0;
-                    acct.voiceStatus = "N/A";
-                    acct.voiceBanExpiry = 0;
-                    continue;  // Skip processing like banned accounts
-                } else if (banInfo.status == Roblox::BanCheckResult::Terminated) {
-                    acct.status = "Terminated";
-                    acct.banExpiry = 0;
-                    acct.voiceStatus = "N/A";
-                    acct.voiceBanExpiry = 0;
-                    continue;
-                } else if (banInfo.status == Roblox::BanCheckResult::Unbanned) {
-                    // Get fresh data from authenticated endpoint
-                    auto userJson = Roblox::getAuthenticatedUser(acct.cookie);
-                    if (!userJson.empty()) {
-                        // Update everything from authenticated data
-                        acct.userId = std::to_string(userJson.value("id", 0ULL));
-                        acct.username = userJson.value("name", "");
-                        acct.displayName = userJson.value("displayName", "");
-                        needsUserInfoUpdate = false;
-
-                        try {
-                            uid = std::stoull(acct.userId);
-                            auto presences = Roblox::getPresences({uid}, acct.cookie);
-                            if (!presences.empty()) {
-                                auto it = presences.find(uid);
-                                if (it != presences.end()) {
-                                    acct.status = it->second.presence;
-                                    acct.lastLocation = it->second.lastLocation;
-                                    acct.placeId = it->second.placeId;
-                                    acct.jobId = it->second.jobId;
-                                } else {
-                                    acct.status = "Offline";
-                                    acct.lastLocation = "";
-                                    acct.placeId = 0;
-                                    acct.jobId.clear();
-                                }
-                            } else {
-                                acct.status = Roblox::getPresence(acct.cookie, uid);
-                                acct.lastLocation = "";
-                                acct.placeId = 0;
-                                acct.jobId.clear();
-                            }
-                            auto vs = Roblox::getVoiceChatStatus(acct.cookie);
-                            acct.voiceStatus = vs.status;
-                            acct.voiceBanExpiry = vs.bannedUntil;
-                            acct.banExpiry = 0;
-                        } catch (const std::exception &e) {
-                            LOG_ERROR("Error getting presence: " + std::string(e.what()));
-                            acct.status = "Error";
-                        }
-                    }
-                }
-            }
-
-            // Fall back to userId if cookie failed or is empty
-            if (needsUserInfoUpdate && !acct.userId.empty()) {
-                try {
-                    uid = std::stoull(acct.userId);
-                    auto userInfo = Roblox::getUserInfo(acct.userId);
-                    if (userInfo.id != 0) {
-                        acct.username = userInfo.username;
-                        acct.displayName = userInfo.displayName;
-                        acct.status = "Cookie Invalid";
-                        acct.voiceStatus = "N/A";
-                        acct.voiceBanExpiry = 0;
-                    } else {
-                        acct.status = "Error: Invalid UserID";
-                    }
-                } catch (const std::exception &e) {
-                    char errorMsg[256];
-                    snprintf(errorMsg, sizeof(errorMsg), "Error converting userId %s: %s", acct.userId.c_str(),
-                             e.what());
-                    LOG_ERROR(errorMsg);
-                    acct.status = "Error: Invalid UserID";
-                }
-            }
-        }
-        Data::SaveAccounts();
-        LOG_INFO("Loaded accounts and refreshed statuses");
-
-        if (!invalidIds.empty()) {
-            std::string namesCopy = names;
-            MainThread::Post([invalidIds, namesCopy]() {
-                char buf[512];
-                snprintf(buf, sizeof(buf), "Invalid cookies for: %s. Remove them?", namesCopy.c_str());
-                ConfirmPopup::Add(buf, [invalidIds]() {
-                    erase_if(g_accounts, [&](const AccountData &a) {
-                        return std::find(invalidIds.begin(), invalidIds.end(), a.id) != invalidIds.end();
-                    });
-                    for (int id: invalidIds) {
-                        g_selectedAccountIds.erase(id);
-                    }
-                    Data::SaveAccounts();
-                });
-            });
-        }
-    };
-
-    Threading::newThread([refreshAccounts] {
-        refreshAccounts();
-        while (true) {
-            std::this_thread::sleep_for(std::chrono::minutes(g_statusRefreshInterval));
-            LOG_INFO("Refreshing account statuses...");
-            refreshAccounts();
-            LOG_INFO("Refreshed account statuses");
-        }
-    });
+    AccountRefresh::StartPeriodicRefresh();
 
     WNDCLASSEXW wc = {
         sizeof(wc), CS_CLASSDC, WndProc, 0L, 0L,
@@ -422,7 +275,7 @@ int WINAPI WinMain(
         if (done)
             break;
 
-        MainThread::Process();
+        MainThread::Process(std::chrono::milliseconds(g_mainThreadBudgetMs));
 
         if (g_SwapChainOccluded && g_pSwapChain->Present(0, DXGI_PRESENT_TEST) == DXGI_STATUS_OCCLUDED) {
             Sleep(10);
@@ -464,6 +317,8 @@ int WINAPI WinMain(
         g_SwapChainOccluded = (hr_present == DXGI_STATUS_OCCLUDED);
     }
 
+    Data::SavePending();
+    Threading::ThreadPool::instance().shutdown();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImGui::DestroyContext();
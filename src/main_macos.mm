@@ -10,11 +10,13 @@
 
 #include "../ui.h"
 #include "components/data.h"
+#include "components/accounts/account_refresh.h"
 #include "network/roblox.h"
 #include "ui/notifications.h"
 #include "core/logging.hpp"
 #include "ui/confirm.h"
 #include "system/main_thread.h"
+#include "system/threading.h"
 #include "system/update.h"
 
 #include <cstdio>
@@ -198,7 +200,7 @@ bool LoadTextureFromFile(const char *file_name, void **out_texture, int *out_wid
 
 - (void)drawInMTKView:(MTKView *)view {
     // Process main thread tasks
-    MainThread::Process();
+    MainThread::Process(std::chrono::milliseconds(g_mainThreadBudgetMs));
 
     ImGuiIO &io = ImGui::GetIO();
     io.DisplaySize.x = view.bounds.size.width;
@@ -254,155 +256,24 @@ bool LoadTextureFromFile(const char *file_name, void **out_texture, int *out_wid
 
 @end
 
+// Writes saves still waiting on their debounce and stops the worker pool.
+static void FlushBeforeExit() {
+    Data::SavePending();
+    Threading::ThreadPool::instance().shutdown();
+}
+
 int main(int argc, const char * argv[]) {
     @autoreleasepool {
         // Load data before creating UI
         Data::LoadSettings("settings.json");
+        Roblox::configureTransportFromEnvironment();
         if (g_checkUpdatesOnStartup) {
             CheckForUpdates();
         }
         Data::LoadAccounts("accounts.json");
         Data::LoadFriends("friends.json");
 
-        // Start background refresh thread
-        auto refreshAccounts = [] {
-            std::vector<int> invalidIds;
-            std::string names;
-            for (auto &acct: g_accounts) {
-                if (acct.cookie.empty())
-                    continue;
-                auto banInfo = Roblox::checkBanStatus(acct.cookie);
-                if (banInfo.status == Roblox::BanCheckResult::InvalidCookie) {
-                    invalidIds.push_back(acct.id);
-                    if (!names.empty())
-                        names += ", ";
-                    names += acct.displayName.empty() ? acct.username : acct.displayName;
-                } else if (banInfo.status == Roblox::BanCheckResult::Banned) {
-                    acct.status = "Banned";
-                    acct.banExpiry = banInfo.endDate;
-                    g_selectedAccountIds.erase(acct.id);
-                } else if (banInfo.status == Roblox::BanCheckResult::Warned) {
-                    acct.status = "Warned";
-                    acct.banExpiry = 0;
-                    g_selectedAccountIds.erase(acct.id);
-                } else if (banInfo.status == Roblox::BanCheckResult::Terminated) {
-                    acct.status = "Terminated";
-                    acct.banExpiry = 0;
-                    g_selectedAccountIds.erase(acct.id);
-                }
-            }
-            
-            // Refresh all account info...
-            for (auto &acct: g_accounts) {
-                if (acct.cookie.empty() && acct.userId.empty())
-                    continue;
-
-                bool needsUserInfoUpdate = true;
-                uint64_t uid = 0;
-
-                if (!acct.cookie.empty()) {
-                    auto banInfo = Roblox::checkBanStatus(acct.cookie);
-                    if (banInfo.status == Roblox::BanCheckResult::Banned) {
-                        acct.status = "Banned";
-                        acct.banExpiry = banInfo.endDate;
-                        acct.voiceStatus = "N/A";
-                        acct.voiceBanExpiry = 0;
-                        continue;
-                    } else if (banInfo.status == Roblox::BanCheckResult::Warned) {
-                        acct.status = "Warned";
-                        acct.banExpiry = 0;
-                        acct.voiceStatus = "N/A";
-                        acct.voiceBanExpiry = 0;
-                        continue;
-                    } else if (banInfo.status == Roblox::BanCheckResult::Terminated) {
-                        acct.status = "Terminated";
-                        acct.banExpiry = 0;
-                        acct.voiceStatus = "N/A";
-                        acct.voiceBanExpiry = 0;
-                        continue;
-                    } else if (banInfo.status == Roblox::BanCheckResult::Unbanned) {
-                        auto userJson = Roblox::getAuthenticatedUser(acct.cookie);
-                        if (!userJson.empty()) {
-                            acct.userId = std::to_string(userJson.value("id", 0ULL));
-                            acct.username = userJson.value("name", "");
-                            acct.displayName = userJson.value("displayName", "");
-                            needsUserInfoUpdate = false;
-
-                            try {
-                                uid = std::stoull(acct.userId);
-                                auto presences = Roblox::getPresences({uid}, acct.cookie);
-                                if (!presences.empty()) {
-                                    auto it = presences.find(uid);
-                                    if (it != presences.end()) {
-                                        acct.status = it->second.presence;
-                                        acct.lastLocation = it->second.lastLocation;
-                                        acct.placeId = it->second.placeId;
-                                        acct.jobId = it->second.jobId;
-                                    } else {
-                                        acct.status = "Offline";
-                                    }
-                                } else {
-                                    acct.status = Roblox::getPresence(acct.cookie, uid);
-                                }
-                                auto vs = Roblox::getVoiceChatStatus(acct.cookie);
-                                acct.voiceStatus = vs.status;
-                                acct.voiceBanExpiry = vs.bannedUntil;
-                                acct.banExpiry = 0;
-                            } catch (...) {
-                                acct.status = "Error";
-                            }
-                        }
-                    }
-                }
-
-                if (needsUserInfoUpdate && !acct.userId.empty()) {
-                    try {
-                        uid = std::stoull(acct.userId);
-                        auto userInfo = Roblox::getUserInfo(acct.userId);
-                        if (userInfo.id != 0) {
-                            acct.username = userInfo.username;
-                            acct.displayName = userInfo.displayName;
-                            acct.status = "Cookie Invalid";
-                            acct.voiceStatus = "N/A";
-                            acct.voiceBanExpiry = 0;
-                        } else {
-                            acct.status = "Error: Invalid UserID";
-                        }
-                    } catch (...) {
-                        acct.status = "Error: Invalid UserID";
-                    }
-                }
-            }
-            Data::SaveAccounts();
-            LOG_INFO("Loaded accounts and refreshed statuses");
-
-            if (!invalidIds.empty()) {
-                std::string namesCopy = names;
-                MainThread::Post([invalidIds, namesCopy]() {
-                    char buf[512];
-                    snprintf(buf, sizeof(buf), "Invalid cookies for: %s. Remove them?", namesCopy.c_str());
-                    ConfirmPopup::Add(buf, [invalidIds]() {
-                        erase_if(g_accounts, [&](const AccountData &a) {
-                            return std::find(invalidIds.begin(), invalidIds.end(), a.id) != invalidIds.end();
-                        });
-                        for (int id: invalidIds) {
-                            g_selectedAccountIds.erase(id);
-                        }
-                        Data::SaveAccounts();
-                    });
-                });
-            }
-        };
-
-        Threading::newThread([refreshAccounts] {
-            refreshAccounts();
-            while (true) {
-                std::this_thread::sleep_for(std::chrono::minutes(g_statusRefreshInterval));
-                LOG_INFO("Refreshing account statuses...");
-                refreshAccounts();
-                LOG_INFO("Refreshed account statuses");
-            }
-        });
+        AccountRefresh::StartPeriodicRefresh();
 
         // Create application
         NSApplication *app = [NSApplication sharedApplication];
@@ -427,8 +298,18 @@ int main(int argc, const char * argv[]) {
         [window makeKeyAndOrderFront:nil];
         [app activateIgnoringOtherApps:YES];
 
+        // -terminate: exits the process without returning from -run, so the
+        // flush has to happen from its notification.
+        [[NSNotificationCenter defaultCenter] addObserverForName:NSApplicationWillTerminateNotification
+                                                          object:nil
+                                                           queue:nil
+                                                      usingBlock:^(NSNotification *) {
+                                                          FlushBeforeExit();
+                                                      }];
+
         // Run app
         [app run];
     }
+    FlushBeforeExit();
     return 0;
 }
\ No newline at end of file
@@ -16,6 +16,7 @@
 #include "ui/modal_popup.h"
 #include "ui/confirm.h"
 #include "avatar/inventory.h"
+#include "core/account_utils.h"
 
 using namespace ImGui;
 
@@ -47,8 +48,29 @@ int g_activeTab = Tab_Accounts;
 uint64_t g_targetPlaceId_ServersTab = 0;
 uint64_t g_targetUniverseId_ServersTab = 0;
 
+// Selected accounts are the ones about to be launched, so their tickets are
+// minted as soon as the selection changes rather than when Launch is pressed.
+static void PreMintSelectedTickets()
+{
+    static std::set<int> lastSelection;
+    if (!g_preMintAuthTickets || g_selectedAccountIds == lastSelection)
+        return;
+    lastSelection = g_selectedAccountIds;
+
+    std::vector<std::string> cookies;
+    for (const auto &acct : g_accounts)
+    {
+        if (g_selectedAccountIds.count(acct.id) && !acct.cookie.empty() && AccountFilters::IsAccountUsable(acct))
+            cookies.push_back(acct.cookie);
+    }
+    if (!cookies.empty())
+        Roblox::AuthTicketPool::instance().prefill(cookies);
+}
+
 bool RenderUI()
 {
+    PreMintSelectedTickets();
+
     bool exit_from_menu = RenderMainMenu();
     bool exit_from_content = false;
 
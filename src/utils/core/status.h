@@ -1,51 +1,32 @@
 ﻿#pragma once
 #include <mutex>
 #include <string>
-#include <thread>
 #include <chrono>
 #include "modal_popup.h"
+#include "system/timers.h"
 
 using namespace std;
 
 namespace Status {
+	// Set() shows its text with a countdown from kCountdownSeconds to 0, then
+	// falls back to "Idle".
+	inline constexpr int kCountdownSeconds = 5;
+
 	inline mutex _mtx;
 	inline string _originalText = "Idle";
-	inline string _displayText = "Idle";
-
-	inline chrono::steady_clock::time_point _lastSetTime{};
+	inline chrono::steady_clock::time_point _idleAt{};
+	inline Timers::Handle _idleTimer = 0;
 
 	inline void Set(const string &s) {
-		auto tp = chrono::steady_clock::now(); {
+		lock_guard<mutex> lock(_mtx);
+		_originalText = s;
+		_idleAt = chrono::steady_clock::now() + chrono::seconds(kCountdownSeconds + 1);
+		Timers::cancel(_idleTimer);
+		_idleTimer = Timers::at(_idleAt, [idleAt = _idleAt]() {
 			lock_guard<mutex> lock(_mtx);
-			_originalText = s;
-			_displayText = _originalText + " (5)";
-			_lastSetTime = tp;
-		}
-
-		thread([tp, s]() {
-			for (int i = 5; i >= 0; --i) {
-				{
-					lock_guard<mutex> lock(_mtx);
-					if (_lastSetTime != tp) {
-						return;
-					}
-				}
-
-				this_thread::sleep_for(chrono::seconds(1));
-				lock_guard<mutex> lock(_mtx);
-
-				if (_lastSetTime == tp) {
-					if (i > 0) {
-						_displayText = s + " (" + to_string(i - 1) + ")";
-					} else {
-						_displayText = "Idle";
-						_originalText = "Idle";
-					}
-				} else {
-					return;
-				}
-			}
-		}).detach();
+			if (_idleAt == idleAt) // not replaced by a Set() racing this timer
+				_originalText = "Idle";
+		});
 	}
 
 	inline void Error(const string &s) {
@@ -55,6 +36,9 @@ namespace Status {
 
 	inline string Get() {
 		lock_guard<mutex> lock(_mtx);
-		return _displayText;
+		auto left = _idleAt - chrono::steady_clock::now();
+		if (_originalText == "Idle" || left <= chrono::steady_clock::duration::zero())
+			return "Idle";
+		return _originalText + " (" + to_string(chrono::duration_cast<chrono::seconds>(left).count()) + ")";
 	}
 }
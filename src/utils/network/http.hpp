@@ -2,82 +2,322 @@
 
 #include <string>
 #include <map>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <istream>
 #include <initializer_list>
+#include <memory>
+#include <optional>
 #include <sstream>
+#include <thread>
 #include <cpr/cpr.h>
 #include <nlohmann/json.hpp>
 #include "core/logging.hpp"
+#include "http_pool.hpp"
+#include "http_async.hpp"
+#include "http_cache.hpp"
+#include "http_metrics.hpp"
+#include "http_rate_limit.hpp"
+#include "http_sax.hpp"
+#include "http_single_flight.hpp"
+#include "http_stream.hpp"
+#include "http_transport.hpp"
+#include "http_types.hpp"
 
 using namespace std;
 
 namespace HttpClient {
-	struct Response {
-		int status_code;
-		string text;
-		map<string, string> headers;
-	};
+	// 429 means the request was rejected before processing, so it is safe to
+	// resend for any method; 503 is only retried for reads.
+	inline bool shouldRetry(const Request &req, int status, int attempt) {
+		if (attempt >= RateLimiter::kMaxRetries || !isRetryableStatus(status))
+			return false;
+		return status == 429 || req.method == "GET";
+	}
+
+	inline std::chrono::milliseconds retryAfterOf(const Response &r) {
+		auto v = findHeader(r, "retry-after");
+		return v ? parseRetryAfter(*v) : std::chrono::milliseconds{0};
+	}
+
+	// Approximate wire sizes for HttpMetrics (headers included, framing not).
+	inline size_t requestBytes(const Request &req) {
+		size_t n = req.method.size() + req.url.size() + queryOf(req).size() + req.body.size();
+		for (const auto &[k, v]: req.headers)
+			n += k.size() + v.size() + 4;
+		return n;
+	}
+
+	inline size_t responseBytes(const Response &r) {
+		size_t n = r.text.size();
+		for (const auto &[k, v]: r.headers)
+			n += k.size() + v.size() + 4;
+		return n;
+	}
+
+	// Sends `req` on the calling thread, waiting for the endpoint family's rate
+	// limit and retrying throttled responses with jittered exponential backoff.
+	inline Response send(const Request &req) {
+		const std::string family = endpointFamily(req.url);
+		for (int attempt = 0;; ++attempt) {
+			if (req.context.expired())
+				return {};
+			RateLimiter::instance().acquire(family);
 
-	inline string build_kv_string(
-		initializer_list<pair<const string, string> > items,
-		char sep = '&'
+			auto started = std::chrono::steady_clock::now();
+			HttpMetrics::instance().started();
+			Response r = transport()->perform(req);
+			HttpMetrics::instance().finished(
+				family, r.status_code, std::chrono::steady_clock::now() - started, requestBytes(req), responseBytes(r));
+
+			auto retryAfter = retryAfterOf(r);
+			int status = r.status_code;
+			RateLimiter::instance().onResponse(family, status, retryAfter);
+			if (!shouldRetry(req, status, attempt))
+				return r;
+
+			HttpMetrics::instance().retried(family);
+			auto delay = backoffDelay(attempt, retryAfter);
+			LOG_INFO(
+				"HTTP " + std::to_string(status) + " from " + family + ", retrying in " +
+				std::to_string(delay.count()) + " ms");
+			if (!sleepUnlessExpired(req.context, delay))
+				return {};
+		}
+	}
+
+	// Asynchronous counterpart of send(): waiting for rate-limit capacity and
+	// retry backoff happens inside the transport (the I/O loop for live
+	// traffic) instead of on a thread.
+	//
+	// With a `sink`, a successful body is streamed to it instead of being
+	// buffered (retried attempts never reach the sink, only 2xx bodies do).
+	inline void sendAsync(
+		std::shared_ptr<const Request> req,
+		Callback onDone,
+		int attempt = 0,
+		std::chrono::steady_clock::time_point notBefore = {},
+		ChunkSink sink = {}
 	) {
-		ostringstream ss;
-		bool first = true;
-		for (auto &kv: items) {
-			if (!first) ss << sep;
-			first = false;
-			ss << kv.first << '=' << kv.second;
+		// Cancelled or overdue requests complete with status 0 and are not sent.
+		if (req->context.expired()) {
+			onDone(Response{});
+			return;
+		}
+		const std::string family = endpointFamily(req->url);
+		auto reservation = RateLimiter::instance().reserve(family);
+		auto startAt = std::max(reservation.at, notBefore);
+		// Latency counts from when the transfer may start, so rate-limit and
+		// backoff waits do not inflate it.
+		auto measuredFrom = std::max(startAt, std::chrono::steady_clock::now());
+		auto streamed = std::make_shared<size_t>(0);
+		auto completion = [req, family, attempt, measuredFrom, streamed, sink, onDone = std::move(onDone)](
+			Response r) mutable {
+			HttpMetrics::instance().finished(
+				family, r.status_code, std::chrono::steady_clock::now() - measuredFrom,
+				requestBytes(*req), responseBytes(r) + *streamed);
+
+			auto retryAfter = retryAfterOf(r);
+			int status = r.status_code;
+			RateLimiter::instance().onResponse(family, status, retryAfter);
+			if (!shouldRetry(*req, status, attempt) || req->context.expired()) {
+				onDone(std::move(r));
+				return;
+			}
+			HttpMetrics::instance().retried(family);
+			auto when = std::chrono::steady_clock::now() + backoffDelay(attempt, retryAfter);
+			sendAsync(std::move(req), std::move(onDone), attempt + 1, when, std::move(sink));
+		};
+
+		HttpMetrics::instance().started();
+		if (!sink) {
+			transport()->performAsync(req, startAt, std::move(reservation.slot), std::move(completion));
+			return;
+		}
+		transport()->performStreamAsync(
+			req, startAt, std::move(reservation.slot),
+			[sink, streamed](std::string_view chunk) {
+				*streamed += chunk.size();
+				return sink(chunk);
+			},
+			std::move(completion));
+	}
+
+	// Identity of a response for the cache: method, URL, query and every header,
+	// so responses fetched with different cookies are never shared.
+	inline std::string cacheKey(const Request &req) {
+		std::string key = req.method + ' ' + req.url;
+		std::string query = queryOf(req);
+		if (!query.empty())
+			key += '?' + query;
+		for (const auto &[name, value]: req.headers) {
+			key += '\n';
+			key += name;
+			key += ':';
+			key += value;
+		}
+		return key;
+	}
+
+	// Identity of a request for coalescing: the cache key plus the cancel
+	// token, so one owner giving up never fails another owner's request.
+	inline std::string flightKey(const Request &req) {
+		std::string key = cacheKey(req);
+		if (req.context.cancel) {
+			std::ostringstream owner;
+			owner << req.context.cancel.id();
+			key += "\ncancel:" + owner.str();
+		}
+		return key;
+	}
+
+	inline SingleFlight<Response> &responseFlights() {
+		static SingleFlight<Response> flights;
+		return flights;
+	}
+
+	// Cache bookkeeping for one GET: the lookup result plus the request to send,
+	// which carries If-None-Match/If-Modified-Since when a stale entry exists.
+	struct CachedFetch {
+		const CachePolicy *policy = nullptr;
+		std::string key;
+		std::optional<CacheEntry> entry;
+		Request request;
+
+		bool servable() const { return entry && entry->fresh(); }
+	};
+
+	// `fresh` skips the lookup so the request always goes out; a cacheable
+	// answer still replaces the stored entry.
+	inline CachedFetch beginCachedFetch(const Request &req, bool fresh = false) {
+		// Replayed and synthetic responses must never end up in the real cache.
+		bool cacheable = req.method == "GET" && transport()->live();
+		CachedFetch f{cacheable ? cachePolicyFor(req.url) : nullptr, {}, std::nullopt, req};
+		if (!f.policy)
+			return f;
+		f.key = cacheKey(req);
+		if (fresh)
+			return f;
+		f.entry = HttpCache::instance().lookup(f.key);
+		if (f.entry && !f.entry->fresh()) {
+			if (!f.entry->etag.empty())
+				f.request.headers["If-None-Match"] = f.entry->etag;
+			if (!f.entry->lastModified.empty())
+				f.request.headers["If-Modified-Since"] = f.entry->lastModified;
+		}
+		return f;
+	}
+
+	inline Response responseFromCache(const CacheEntry &e) {
+		Response r{e.status_code, e.body, {}};
+		if (!e.contentType.empty())
+			r.headers["content-type"] = e.contentType;
+		return r;
+	}
+
+	// Turns the network result into what the caller sees: a 304 is answered
+	// from the stale entry, cacheable 200s are stored.
+	inline Response finishCachedFetch(const CachedFetch &f, Response resp) {
+		if (!f.policy)
+			return resp;
+		if (resp.status_code == 304 && f.entry) {
+			HttpCache::instance().refresh(f.key, f.policy->ttl);
+			return responseFromCache(*f.entry);
 		}
-		return ss.str();
+		// Thumbnail batches answer "Pending" while an image is still rendering.
+		if (resp.status_code == 200 && resp.text.find("\"Pending\"") == std::string::npos) {
+			CacheEntry e;
+			e.status_code = resp.status_code;
+			e.body = resp.text;
+			e.expiresAt = std::chrono::system_clock::now() + f.policy->ttl;
+			if (auto v = findHeader(resp, "content-type")) e.contentType = *v;
+			if (auto v = findHeader(resp, "etag")) e.etag = *v;
+			if (auto v = findHeader(resp, "last-modified")) e.lastModified = *v;
+			HttpCache::instance().store(f.key, std::move(e));
+		}
+		return resp;
+	}
+
+	inline Response fetch(const Request &req, bool fresh = false) {
+		auto f = beginCachedFetch(req, fresh);
+		if (f.servable())
+			return responseFromCache(*f.entry);
+		return finishCachedFetch(f, send(f.request));
 	}
 
+	// Concurrent identical GETs share one network request.
 	inline Response get(
 		const std::string &url,
-		std::initializer_list<std::pair<const std::string, std::string> > headers = {},
+		HeaderList headers = {},
 		cpr::Parameters params = {}
 	) {
-		auto r = cpr::Get(
-			cpr::Url{url},
-			cpr::Header{headers},
-			params // <-- directly pass it
-		);
-		std::map<std::string, std::string> hdrs(r.header.begin(), r.header.end());
-		return {static_cast<int>(r.status_code), r.text, hdrs};
+		Request req = makeGet(url, headers, std::move(params));
+		std::string key = flightKey(req);
+		return takeResult(responseFlights().run(key, [&] { return fetch(req); }));
 	}
 
 	inline Response post(
 		const string &url,
-		initializer_list<pair<const string, string> > headers = {},
+		HeaderList headers = {},
 		const string &jsonBody = string(),
-		initializer_list<pair<const string, string> > form = {}
+		HeaderList form = {}
 	) {
-		cpr::Header h{headers};
-		cpr::Response r;
-		if (!jsonBody.empty()) {
-			h["Content-Type"] = "application/json";
-			r = cpr::Post(
-				cpr::Url{url},
-				h,
-				cpr::Body{jsonBody}
-			);
-		} else if (form.size() > 0) {
-			string body = build_kv_string(form);
-			h["Content-Type"] = "application/x-www-form-urlencoded";
-			r = cpr::Post(
-				cpr::Url{url},
-				h,
-				cpr::Body{body}
-			);
-		} else {
-			r = cpr::Post(
-				cpr::Url{url},
-				h
-			);
+		return send(makePost(url, headers, jsonBody, form));
+	}
+
+	// Non-blocking variants: the request runs on the shared IoLoop thread and
+	// `onDone` is invoked there once the response arrives.
+	inline void getAsync(const std::string &url, HeaderList headers, cpr::Parameters params, Callback onDone) {
+		auto req = std::make_shared<const Request>(makeGet(url, headers, std::move(params)));
+		std::string key = flightKey(*req);
+		bool leader = responseFlights().join(key, [onDone = std::move(onDone)](std::shared_ptr<const Response> r) {
+			onDone(r ? r->clone() : Response{});
+		});
+		if (!leader)
+			return;
+
+		// A fresh cache hit completes inline on the caller's thread.
+		auto f = std::make_shared<const CachedFetch>(beginCachedFetch(*req));
+		if (f->servable()) {
+			responseFlights().complete(key, std::make_shared<const Response>(responseFromCache(*f->entry)));
+			return;
 		}
-		map<string, string> hdrs(r.header.begin(), r.header.end());
-		return {static_cast<int>(r.status_code), r.text, hdrs};
+		sendAsync(std::make_shared<const Request>(f->request), [key, f](Response r) {
+			responseFlights().complete(key, std::make_shared<const Response>(finishCachedFetch(*f, std::move(r))));
+		});
+	}
+
+	inline std::future<Response> getAsync(const std::string &url, HeaderList headers = {}, cpr::Parameters params = {}) {
+		auto promise = std::make_shared<std::promise<Response> >();
+		auto future = promise->get_future();
+		getAsync(url, headers, std::move(params), [promise](Response r) { promise->set_value(std::move(r)); });
+		return future;
+	}
+
+	inline void postAsync(
+		const std::string &url,
+		HeaderList headers,
+		const std::string &jsonBody,
+		HeaderList form,
+		Callback onDone
+	) {
+		sendAsync(std::make_shared<const Request>(makePost(url, headers, jsonBody, form)), std::move(onDone));
 	}
 
+	inline std::future<Response> postAsync(
+		const std::string &url,
+		HeaderList headers = {},
+		const std::string &jsonBody = std::string(),
+		HeaderList form = {}
+	) {
+		auto promise = std::make_shared<std::promise<Response> >();
+		auto future = promise->get_future();
+		postAsync(url, headers, jsonBody, form, [promise](Response r) { promise->set_value(std::move(r)); });
+		return future;
+	}
 
 	inline nlohmann::json decode(const Response &response) {
 		try {
@@ -87,4 +327,113 @@ namespace HttpClient {
 			return nlohmann::json::object();
 		}
 	}
+
+	struct JsonResponse {
+		int status_code = 0;
+		nlohmann::json body;
+	};
+
+	inline SingleFlight<JsonResponse> &jsonFlights() {
+		static SingleFlight<JsonResponse> flights;
+		return flights;
+	}
+
+	// GET + decode in one step. Identical calls already in flight share both the
+	// network request and the parsed document; `body` is null on HTTP errors.
+	// `fresh` asks Roblox even when a cached copy is still valid and stores the
+	// answer; it only joins other fresh calls, never a cached read.
+	inline std::shared_ptr<const JsonResponse> getJson(
+		const std::string &url,
+		HeaderList headers = {},
+		cpr::Parameters params = {},
+		bool fresh = false
+	) {
+		Request req = makeGet(url, headers, std::move(params));
+		std::string key = flightKey(req);
+		if (fresh)
+			key += "\nfresh";
+		auto shared = jsonFlights().run(key, [&] {
+			Response r = fetch(req, fresh);
+			JsonResponse out{r.status_code, nullptr};
+			if (r.status_code >= 200 && r.status_code < 300)
+				out.body = decode(r);
+			return out;
+		});
+		return shared ? shared : std::make_shared<const JsonResponse>();
+	}
+
+	// Like getJson(), but the document is parsed while it downloads instead of
+	// being buffered into a string first. Bypasses the response cache, so it is
+	// meant for large uncached listings (servers, inventory, friends, search).
+	// Blocks the caller; never call it from an I/O completion callback.
+	inline std::shared_ptr<const JsonResponse> getJsonStreamed(
+		const std::string &url,
+		HeaderList headers = {},
+		cpr::Parameters params = {}
+	) {
+		Request req = makeGet(url, headers, std::move(params));
+		std::string key = flightKey(req);
+		auto shared = jsonFlights().run(key, [&] {
+			auto pipe = std::make_shared<ChunkPipe>();
+			auto done = std::make_shared<std::promise<Response> >();
+			auto finished = done->get_future();
+			sendAsync(
+				std::make_shared<const Request>(req),
+				[pipe, done](Response r) {
+					pipe->close();
+					done->set_value(std::move(r));
+				},
+				0, {},
+				[pipe](std::string_view chunk) { return pipe->push(chunk); });
+
+			std::istream in(pipe.get());
+			nlohmann::json body = nlohmann::json::parse(in, nullptr, false);
+			pipe->abandon();
+			Response r = finished.get();
+
+			JsonResponse out{r.status_code, nullptr};
+			if (r.status_code >= 200 && r.status_code < 300) {
+				if (body.is_discarded())
+					LOG_ERROR("Failed to parse streamed JSON from " + url);
+				else
+					out.body = std::move(body);
+			}
+			return out;
+		});
+		return shared ? shared : std::make_shared<const JsonResponse>();
+	}
+
+	struct SaxResponse {
+		int status_code = 0;
+		bool parsed = false; // the body was well-formed and fully handed to the handler
+	};
+
+	// Like getJsonStreamed(), but the body goes to a SAX `handler` as it
+	// downloads and no document is built at all. Not coalesced, since every
+	// caller brings its own handler; what it collected is only meaningful
+	// when the result is a 2xx with `parsed` set.
+	template<typename Handler>
+	SaxResponse getSax(const std::string &url, Handler &handler, HeaderList headers = {}, cpr::Parameters params = {}) {
+		auto pipe = std::make_shared<ChunkPipe>();
+		auto done = std::make_shared<std::promise<Response> >();
+		auto finished = done->get_future();
+		sendAsync(
+			std::make_shared<const Request>(makeGet(url, headers, std::move(params))),
+			[pipe, done](Response r) {
+				pipe->close();
+				done->set_value(std::move(r));
+			},
+			0, {},
+			[pipe](std::string_view chunk) { return pipe->push(chunk); });
+
+		std::istream in(pipe.get());
+		bool parsed = nlohmann::json::sax_parse(in, &handler);
+		pipe->abandon();
+		Response r = finished.get();
+
+		SaxResponse out{r.status_code, parsed};
+		if (r.status_code >= 200 && r.status_code < 300 && !parsed)
+			LOG_ERROR("Failed to parse streamed JSON from " + url);
+		return out;
+	}
 }
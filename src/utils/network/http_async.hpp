@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <curl/curl.h>
+#include <cpr/cpr.h>
+
+#include "http_pool.hpp"
+#include "http_rate_limit.hpp"
+
+namespace HttpClient {
+	// Single background thread driving a curl multi handle. Requests are handed
+	// over as prepared pooled sessions, so hundreds of transfers can be in flight
+	// without one OS thread each. Completion callbacks run on the I/O thread and
+	// must stay short; anything touching UI state belongs in MainThread::Post.
+	class IoLoop {
+		public:
+			using Prepare = std::function<void(cpr::Session &)>;
+			using Completion = std::function<void(cpr::Response)>;
+
+			static constexpr long kMaxConnectionsPerHost = 16;
+			static constexpr long kMaxConnectionsTotal = 64;
+
+			static IoLoop &instance() {
+				static IoLoop loop;
+				return loop;
+			}
+
+			// `prepare` configures the borrowed session and must call one of the
+			// cpr::Session::Prepare* methods (PrepareGet, PreparePost, ...). The
+			// transfer is held back until `notBefore`, which is how rate-limiter
+			// reservations and retry backoff are honoured without blocking a thread.
+			void submit(
+				ConnectionPool::Lease lease,
+				Prepare prepare,
+				Completion done,
+				std::chrono::steady_clock::time_point notBefore = {},
+				RateLimiter::QueueSlot slot = {}
+			) {
+				auto job = std::make_unique<Job>(
+					Job{std::move(lease), std::move(prepare), std::move(done), notBefore, std::move(slot)}
+				); {
+					std::lock_guard<std::mutex> lock(mtx_);
+					pending_.push_back(std::move(job));
+					ensureStarted();
+				}
+				curl_multi_wakeup(multi_);
+			}
+
+			size_t inFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+
+		private:
+			struct Job {
+				ConnectionPool::Lease lease;
+				Prepare prepare;
+				Completion done;
+				std::chrono::steady_clock::time_point notBefore;
+				RateLimiter::QueueSlot slot;
+			};
+
+			IoLoop() {
+				multi_ = curl_multi_init();
+				curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, kMaxConnectionsPerHost);
+				curl_multi_setopt(multi_, CURLMOPT_MAX_TOTAL_CONNECTIONS, kMaxConnectionsTotal);
+			}
+
+			~IoLoop() {
+				stop_ = true;
+				curl_multi_wakeup(multi_);
+				if (worker_.joinable())
+					worker_.join();
+				for (auto &[handle, _]: active_)
+					curl_multi_remove_handle(multi_, handle);
+				active_.clear();
+				curl_multi_cleanup(multi_);
+			}
+
+			void ensureStarted() {
+				if (!worker_.joinable())
+					worker_ = std::thread([this] { run(); });
+			}
+
+			void run() {
+				while (!stop_) {
+					int timeoutMs = startPending();
+
+					int running = 0;
+					curl_multi_perform(multi_, &running);
+					drainCompleted();
+
+					curl_multi_poll(multi_, nullptr, 0, timeoutMs, nullptr);
+				}
+			}
+
+			// Starts every job whose start time has come and returns how long the
+			// loop may sleep before the next delayed job is due.
+			int startPending() {
+				auto now = std::chrono::steady_clock::now();
+				auto nextDue = now + std::chrono::seconds(1);
+				std::vector<std::unique_ptr<Job> > batch; {
+					std::lock_guard<std::mutex> lock(mtx_);
+					for (auto &job: pending_) {
+						if (job->notBefore <= now)
+							batch.push_back(std::move(job));
+						else
+							nextDue = std::min(nextDue, job->notBefore);
+					}
+					std::erase(pending_, nullptr);
+				}
+				for (auto &job: batch) {
+					job->slot.reset();
+					job->prepare(job->lease.session());
+					CURL *handle = job->lease.session().GetCurlHolder()->handle;
+					if (curl_multi_add_handle(multi_, handle) != CURLM_OK) {
+						finish(std::move(job), CURLE_FAILED_INIT);
+						continue;
+					}
+					inFlight_.fetch_add(1, std::memory_order_relaxed);
+					active_.emplace(handle, std::move(job));
+				}
+				auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextDue - now).count();
+				return static_cast<int>(std::clamp<long long>(wait, 1, 1000));
+			}
+
+			void drainCompleted() {
+				int remaining = 0;
+				while (CURLMsg *msg = curl_multi_info_read(multi_, &remaining)) {
+					if (msg->msg != CURLMSG_DONE)
+						continue;
+					CURL *handle = msg->easy_handle;
+					CURLcode result = msg->data.result;
+					curl_multi_remove_handle(multi_, handle);
+
+					auto it = active_.find(handle);
+					if (it == active_.end())
+						continue;
+					auto job = std::move(it->second);
+					active_.erase(it);
+					inFlight_.fetch_sub(1, std::memory_order_relaxed);
+					finish(std::move(job), result);
+				}
+			}
+
+			static void finish(std::unique_ptr<Job> job, CURLcode result) {
+				cpr::Response response = job->lease.session().Complete(result);
+				// Never park a session whose transfer failed; its connection may be broken.
+				if (result != CURLE_OK || response.status_code == 0)
+					job->lease.discard();
+				auto done = std::move(job->done);
+				// Hand the session back to the pool before user code runs.
+				job.reset();
+				if (done)
+					done(std::move(response));
+			}
+
+			CURLM *multi_ = nullptr;
+			std::thread worker_;
+			std::atomic<bool> stop_{false};
+			std::atomic<size_t> inFlight_{0};
+
+			std::mutex mtx_;
+			std::vector<std::unique_ptr<Job> > pending_;
+			// Only touched from the I/O thread.
+			std::unordered_map<CURL *, std::unique_ptr<Job> > active_;
+	};
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+#include "http_types.hpp"
+#include "../../components/data.h"
+
+namespace HttpClient {
+	// How long responses from an endpoint may be served without asking Roblox.
+	// Only endpoints listed here are cached at all; a zero TTL opts a more
+	// specific path back out.
+	struct CachePolicy {
+		const char *host;
+		const char *pathContains;
+		std::chrono::seconds ttl;
+	};
+
+	inline const CachePolicy *cachePolicyFor(const std::string &url) {
+		using namespace std::chrono_literals;
+		static const CachePolicy policies[] = {
+			{"games.roblox.com", "/v1/games?universeIds=", 5min},
+			{"users.roblox.com", "/v1/users/authenticated", 0s},
+			{"users.roblox.com", "/v1/users/", 30min},
+			{"inventory.roblox.com", "/categories", 1h},
+			{"thumbnails.roblox.com", "/v1/", 1h},
+			{"rbxcdn.com", "/", 24h},
+		};
+		size_t schemeEnd = url.find("://");
+		size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+		size_t pathStart = url.find_first_of("/?#", hostStart);
+		std::string host = url.substr(hostStart, pathStart - hostStart);
+		std::string path = pathStart == std::string::npos ? std::string("/") : url.substr(pathStart);
+		for (const auto &p: policies) {
+			if (host.find(p.host) != std::string::npos && path.find(p.pathContains) != std::string::npos)
+				return p.ttl.count() > 0 ? &p : nullptr;
+		}
+		return nullptr;
+	}
+
+	struct CacheEntry {
+		int status_code = 0;
+		std::string body;
+		std::string contentType;
+		std::string etag;
+		std::string lastModified;
+		std::chrono::system_clock::time_point expiresAt;
+
+		bool fresh() const { return std::chrono::system_clock::now() < expiresAt; }
+	};
+
+	// Two-level response cache: an in-memory LRU bounded by bytes, backed by one
+	// .meta/.body file pair per entry under storage/cache. Keys are hashed before
+	// touching disk so cookies that end up in a request key are never written out.
+	class HttpCache {
+		public:
+			static constexpr size_t kMaxMemoryBytes = 32 * 1024 * 1024;
+			static constexpr std::chrono::hours kDiskRetention{24 * 7};
+
+			static HttpCache &instance() {
+				static HttpCache cache;
+				return cache;
+			}
+
+			std::optional<CacheEntry> lookup(const std::string &key) {
+				std::string id = digest(key); {
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto it = index_.find(id);
+					if (it != index_.end()) {
+						lru_.splice(lru_.begin(), lru_, it->second);
+						++hits_;
+						return it->second->second;
+					}
+				}
+
+				std::lock_guard<std::mutex> disk(diskLockFor(id));
+				auto entry = readFromDiskLocked(id);
+				std::lock_guard<std::mutex> lock(mtx_);
+				if (!entry) {
+					++misses_;
+					return std::nullopt;
+				}
+				++hits_;
+				insertLocked(id, *entry);
+				return entry;
+			}
+
+			void store(const std::string &key, CacheEntry entry) {
+				std::string id = digest(key);
+				std::lock_guard<std::mutex> disk(diskLockFor(id));
+				writeToDiskLocked(id, entry);
+				std::lock_guard<std::mutex> lock(mtx_);
+				insertLocked(id, std::move(entry));
+			}
+
+			// Extends a stale entry after the server answered 304 Not Modified.
+			void refresh(const std::string &key, std::chrono::seconds ttl) {
+				std::string id = digest(key);
+				std::lock_guard<std::mutex> disk(diskLockFor(id));
+				std::optional<CacheEntry> copy; {
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto it = index_.find(id);
+					if (it == index_.end())
+						return;
+					it->second->second.expiresAt = std::chrono::system_clock::now() + ttl;
+					copy = it->second->second;
+				}
+				writeToDiskLocked(id, *copy);
+			}
+
+			void clear() {
+				std::lock_guard<std::mutex> lock(mtx_);
+				lru_.clear();
+				index_.clear();
+				memoryBytes_ = 0;
+				std::error_code ec;
+				std::filesystem::remove_all(dir_, ec);
+				std::filesystem::create_directories(dir_, ec);
+			}
+
+			uint64_t hits() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return hits_;
+			}
+
+			uint64_t misses() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return misses_;
+			}
+
+		private:
+			using Node = std::pair<std::string, CacheEntry>;
+
+			HttpCache() : dir_(Data::StorageFilePath("cache")) {
+				std::error_code ec;
+				std::filesystem::create_directories(dir_, ec);
+				pruneDisk();
+			}
+
+			static std::string digest(const std::string &key) {
+				// FNV-1a next to std::hash gives a 128-bit name with no raw key on disk.
+				std::ostringstream ss;
+				ss << std::hex << fnv1a(key) << '-' << std::hash<std::string>{}(key);
+				return ss.str();
+			}
+
+			void insertLocked(const std::string &id, CacheEntry entry) {
+				auto it = index_.find(id);
+				if (it != index_.end()) {
+					memoryBytes_ -= it->second->second.body.size();
+					lru_.erase(it->second);
+					index_.erase(it);
+				}
+				memoryBytes_ += entry.body.size();
+				lru_.emplace_front(id, std::move(entry));
+				index_[id] = lru_.begin();
+				while (memoryBytes_ > kMaxMemoryBytes && lru_.size() > 1) {
+					memoryBytes_ -= lru_.back().second.body.size();
+					index_.erase(lru_.back().first);
+					lru_.pop_back();
+				}
+			}
+
+			// Held across an entry's disk access and the matching memory update,
+			// always before mtx_, so a reader never pairs a .meta with the .body
+			// of another write and an older copy never replaces a newer one.
+			std::mutex &diskLockFor(const std::string &id) const {
+				return diskLocks_[std::hash<std::string>{}(id) % diskLocks_.size()];
+			}
+
+			// A hit also bumps both files' write time, which pruneDisk() reads as
+			// the last time the entry was used.
+			std::optional<CacheEntry> readFromDiskLocked(const std::string &id) const {
+				auto metaPath = dir_ / (id + ".meta");
+				auto bodyPath = dir_ / (id + ".body");
+				std::ifstream meta(metaPath);
+				std::ifstream body(bodyPath, std::ios::binary);
+				if (!meta.is_open() || !body.is_open())
+					return std::nullopt;
+				try {
+					nlohmann::json j;
+					meta >> j;
+					CacheEntry e;
+					e.status_code = j.value("status", 0);
+					e.contentType = j.value("contentType", "");
+					e.etag = j.value("etag", "");
+					e.lastModified = j.value("lastModified", "");
+					e.expiresAt = std::chrono::system_clock::time_point(
+						std::chrono::seconds(j.value("expiresAt", 0LL)));
+					std::ostringstream ss;
+					ss << body.rdbuf();
+					e.body = ss.str();
+					std::error_code ec;
+					auto now = std::filesystem::file_time_type::clock::now();
+					std::filesystem::last_write_time(metaPath, now, ec);
+					std::filesystem::last_write_time(bodyPath, now, ec);
+					return e;
+				} catch (const std::exception &) {
+					return std::nullopt;
+				}
+			}
+
+			void writeToDiskLocked(const std::string &id, const CacheEntry &e) const {
+				nlohmann::json j = {
+					{"status", e.status_code},
+					{"contentType", e.contentType},
+					{"etag", e.etag},
+					{"lastModified", e.lastModified},
+					{"expiresAt", std::chrono::duration_cast<std::chrono::seconds>(
+						e.expiresAt.time_since_epoch()).count()}
+				};
+				// Body first: a .meta on disk always describes a complete .body.
+				if (writeFileAtomically(dir_ / (id + ".body"), e.body))
+					writeFileAtomically(dir_ / (id + ".meta"), j.dump());
+			}
+
+			// Writes next to `path` and renames over it, so an interrupted write
+			// never leaves a truncated file behind.
+			static bool writeFileAtomically(const std::filesystem::path &path, const std::string &data) {
+				auto tmp = path;
+				tmp += ".tmp";
+				{
+					std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+					if (!out.is_open())
+						return false;
+					out.write(data.data(), static_cast<std::streamsize>(data.size()));
+					if (!out)
+						return false;
+				}
+				std::error_code ec;
+				std::filesystem::rename(tmp, path, ec);
+				if (!ec)
+					return true;
+				std::filesystem::remove(tmp, ec);
+				return false;
+			}
+
+			// Drops entries nobody has read or written for a week so the folder
+			// stays bounded, plus temp files left by an interrupted write.
+			void pruneDisk() const {
+				std::error_code ec;
+				auto cutoff = std::filesystem::file_time_type::clock::now() - kDiskRetention;
+				for (auto it = std::filesystem::directory_iterator(dir_, ec);
+				     !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+					std::error_code fileEc;
+					auto used = it->last_write_time(fileEc);
+					if (it->path().extension() == ".tmp" || (!fileEc && used < cutoff))
+						std::filesystem::remove(it->path(), fileEc);
+				}
+			}
+
+			std::filesystem::path dir_;
+			mutable std::mutex mtx_;
+			mutable std::array<std::mutex, 32> diskLocks_;
+			std::list<Node> lru_;
+			std::unordered_map<std::string, std::list<Node>::iterator> index_;
+			size_t memoryBytes_ = 0;
+			uint64_t hits_ = 0;
+			uint64_t misses_ = 0;
+	};
+}
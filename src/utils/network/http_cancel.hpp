@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace HttpClient {
+	// Cooperative cancellation flag shared by all work started on behalf of one
+	// owner (a tab, an account refresh). Copies share the same flag; a
+	// default-constructed token can never be cancelled.
+	class CancelToken {
+		public:
+			static CancelToken create() {
+				CancelToken t;
+				t.state_ = std::make_shared<std::atomic<bool> >(false);
+				return t;
+			}
+
+			void cancel() const {
+				if (state_)
+					state_->store(true, std::memory_order_release);
+			}
+
+			bool cancelled() const { return state_ && state_->load(std::memory_order_acquire); }
+
+			explicit operator bool() const { return state_ != nullptr; }
+
+			// Identity of the shared flag, for keys that must not mix owners.
+			const void *id() const { return state_.get(); }
+
+		private:
+			std::shared_ptr<std::atomic<bool> > state_;
+	};
+
+	// What a request carries about its caller: the owner's token and the point
+	// in time after which nobody is waiting for the answer any more.
+	struct RequestContext {
+		CancelToken cancel;
+		std::chrono::steady_clock::time_point deadline{}; // {} means none
+
+		bool expired() const {
+			return cancel.cancelled() ||
+			       (deadline != std::chrono::steady_clock::time_point{} &&
+			        std::chrono::steady_clock::now() >= deadline);
+		}
+	};
+
+	namespace detail {
+		struct ScopeState {
+			CancelToken cancel;
+			std::chrono::milliseconds timeout{0};
+		};
+
+		inline ScopeState &currentScope() {
+			thread_local ScopeState scope;
+			return scope;
+		}
+	}
+
+	// Every request issued on this thread while the scope is alive is tied to
+	// `token` and, with a non-zero `timeout`, gets its own deadline of that
+	// long from when it is made (retries included). Lets existing Roblox::*
+	// helpers be cancelled without threading a token through each signature.
+	class RequestScope {
+		public:
+			explicit RequestScope(CancelToken token, std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) :
+				saved_(detail::currentScope()) {
+				auto &scope = detail::currentScope();
+				if (token)
+					scope.cancel = std::move(token);
+				if (timeout.count() > 0)
+					scope.timeout = scope.timeout.count() > 0 ? std::min(scope.timeout, timeout) : timeout;
+			}
+
+			~RequestScope() { detail::currentScope() = saved_; }
+
+			RequestScope(const RequestScope &) = delete;
+			RequestScope &operator=(const RequestScope &) = delete;
+
+		private:
+			detail::ScopeState saved_;
+	};
+
+	inline RequestContext currentRequestContext() {
+		const auto &scope = detail::currentScope();
+		RequestContext ctx{scope.cancel, {}};
+		if (scope.timeout.count() > 0)
+			ctx.deadline = std::chrono::steady_clock::now() + scope.timeout;
+		return ctx;
+	}
+
+	// Sleeps for `delay` unless the request expires first; returns false then.
+	inline bool sleepUnlessExpired(const RequestContext &ctx, std::chrono::milliseconds delay) {
+		constexpr std::chrono::milliseconds kSlice{100};
+		auto until = std::chrono::steady_clock::now() + delay;
+		while (!ctx.expired()) {
+			auto now = std::chrono::steady_clock::now();
+			if (now >= until)
+				return true;
+			std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until - now, kSlice));
+		}
+		return false;
+	}
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <nlohmann/json.hpp>
+
+namespace HttpClient {
+	// Log-scale latency histogram: four buckets per doubling from 1 ms, so any
+	// percentile is reported within ~19% of the true value in constant memory.
+	class LatencyHistogram {
+		public:
+			static constexpr size_t kBuckets = 72; // 1 ms .. ~4.6 min
+
+			void record(double ms) {
+				++buckets_[bucketOf(ms)];
+				++count_;
+				totalMs_ += ms;
+				if (ms > maxMs_)
+					maxMs_ = ms;
+			}
+
+			// Upper bound of the bucket holding the q-th quantile (0 < q <= 1).
+			double percentile(double q) const {
+				if (count_ == 0)
+					return 0.0;
+				uint64_t rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_)));
+				uint64_t seen = 0;
+				for (size_t i = 0; i < kBuckets; ++i) {
+					seen += buckets_[i];
+					if (seen >= rank)
+						return std::min(upperBound(i), maxMs_);
+				}
+				return maxMs_;
+			}
+
+			uint64_t count() const { return count_; }
+			double meanMs() const { return count_ ? totalMs_ / static_cast<double>(count_) : 0.0; }
+			double maxMs() const { return maxMs_; }
+
+		private:
+			static size_t bucketOf(double ms) {
+				if (ms <= 1.0)
+					return 0;
+				auto i = static_cast<size_t>(std::ceil(std::log2(ms) * 4.0));
+				return std::min(i, kBuckets - 1);
+			}
+
+			static double upperBound(size_t i) { return std::exp2(static_cast<double>(i) / 4.0); }
+
+			std::array<uint64_t, kBuckets> buckets_{};
+			uint64_t count_ = 0;
+			double totalMs_ = 0.0;
+			double maxMs_ = 0.0;
+	};
+
+	struct EndpointMetrics {
+		uint64_t requests = 0; // completed attempts, retries included
+		uint64_t retries = 0;
+		uint64_t failures = 0; // transport errors (no HTTP status)
+		uint64_t bytesIn = 0;
+		uint64_t bytesOut = 0;
+		std::map<int, uint64_t> statuses;
+		LatencyHistogram latency;
+	};
+
+	// Per endpoint-family counters for every attempt that goes through the
+	// transport. Families are the same ones the rate limiter uses; once
+	// kMaxEndpoints are tracked, new ones are counted under kOtherFamily.
+	class HttpMetrics {
+		public:
+			static constexpr size_t kMaxEndpoints = 128;
+			static constexpr const char *kOtherFamily = "other";
+
+			static HttpMetrics &instance() {
+				static HttpMetrics metrics;
+				return metrics;
+			}
+
+			void started() { inFlight_.fetch_add(1, std::memory_order_relaxed); }
+
+			void finished(
+				const std::string &family,
+				int status,
+				std::chrono::steady_clock::duration elapsed,
+				size_t bytesOut,
+				size_t bytesIn
+			) {
+				inFlight_.fetch_sub(1, std::memory_order_relaxed);
+				double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto &m = entryFor(family);
+				++m.requests;
+				if (status == 0)
+					++m.failures;
+				++m.statuses[status];
+				m.bytesIn += bytesIn;
+				m.bytesOut += bytesOut;
+				m.latency.record(ms);
+			}
+
+			void retried(const std::string &family) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				++entryFor(family).retries;
+			}
+
+			size_t inFlight() const { return inFlight_.load(std::memory_order_relaxed); }
+
+			std::map<std::string, EndpointMetrics> snapshot() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return endpoints_;
+			}
+
+			void reset() {
+				std::lock_guard<std::mutex> lock(mtx_);
+				endpoints_.clear();
+			}
+
+			nlohmann::json toJson() const {
+				nlohmann::json endpoints = nlohmann::json::object();
+				for (const auto &[family, m]: snapshot()) {
+					nlohmann::json statuses = nlohmann::json::object();
+					for (const auto &[code, n]: m.statuses)
+						statuses[std::to_string(code)] = n;
+					endpoints[family] = {
+						{"requests", m.requests},
+						{"retries", m.retries},
+						{"failures", m.failures},
+						{"bytesIn", m.bytesIn},
+						{"bytesOut", m.bytesOut},
+						{"statuses", statuses},
+						{"latencyMs", {
+							{"p50", m.latency.percentile(0.50)},
+							{"p95", m.latency.percentile(0.95)},
+							{"p99", m.latency.percentile(0.99)},
+							{"mean", m.latency.meanMs()},
+							{"max", m.latency.maxMs()}
+						}}
+					};
+				}
+				return {{"inFlight", inFlight()}, {"endpoints", endpoints}};
+			}
+
+		private:
+			EndpointMetrics &entryFor(const std::string &family) {
+				auto it = endpoints_.find(family);
+				if (it != endpoints_.end())
+					return it->second;
+				if (endpoints_.size() >= kMaxEndpoints)
+					return endpoints_[kOtherFamily];
+				return endpoints_[family];
+			}
+
+			mutable std::mutex mtx_;
+			std::map<std::string, EndpointMetrics> endpoints_;
+			std::atomic<size_t> inFlight_{0};
+	};
+}
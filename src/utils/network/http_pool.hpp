@@ -0,0 +1,198 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <curl/curl.h>
+#include <cpr/cpr.h>
+
+namespace HttpClient {
+	// Returns "scheme://host[:port]" for a URL, used to key pooled sessions.
+	inline std::string originOf(const std::string &url) {
+		size_t schemeEnd = url.find("://");
+		size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+		size_t hostEnd = url.find_first_of("/?#", hostStart);
+		return url.substr(0, hostEnd);
+	}
+
+	struct PoolStats {
+		uint64_t hits = 0; // requests served by an idle, already-connected session
+		uint64_t newConnections = 0; // sessions created because none were idle
+		uint64_t idleEvictions = 0; // sessions dropped after sitting idle too long
+		size_t idle = 0; // sessions currently parked in the pool
+	};
+
+	// Keeps finished cpr::Sessions parked per origin so the next request to the
+	// same host reuses the live keep-alive connection instead of reconnecting.
+	// All sessions share one curl share handle for DNS and TLS session caches, so
+	// even a freshly created session resumes TLS instead of doing a full handshake.
+	class ConnectionPool {
+		public:
+			static constexpr size_t kMaxIdlePerOrigin = 8;
+			static constexpr std::chrono::seconds kMaxIdleTime{50};
+
+			class Lease {
+				public:
+					Lease(ConnectionPool *pool, std::string key, std::shared_ptr<cpr::Session> session) :
+						pool_(pool), key_(std::move(key)), session_(std::move(session)) {}
+
+					Lease(Lease &&other) noexcept :
+						pool_(other.pool_), key_(std::move(other.key_)), session_(std::move(other.session_)) {
+						other.pool_ = nullptr;
+					}
+
+					Lease(const Lease &) = delete;
+					Lease &operator=(const Lease &) = delete;
+					Lease &operator=(Lease &&) = delete;
+
+					~Lease() {
+						if (pool_ && session_)
+							pool_->release(key_, std::move(session_));
+					}
+
+					cpr::Session &session() { return *session_; }
+					std::shared_ptr<cpr::Session> shared() const { return session_; }
+
+					// Drops the session instead of returning it, e.g. after a transport error.
+					void discard() { session_.reset(); }
+
+				private:
+					ConnectionPool *pool_;
+					std::string key_;
+					std::shared_ptr<cpr::Session> session_;
+			};
+
+			static ConnectionPool &instance() {
+				static ConnectionPool pool;
+				return pool;
+			}
+
+			// `lane` separates sessions by request shape (GET vs. POST) because cpr
+			// keeps body state on a session once it has been set.
+			Lease acquire(const std::string &url, const char *lane) {
+				std::string key = std::string(lane) + ' ' + originOf(url);
+				auto now = std::chrono::steady_clock::now(); {
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto &idle = idle_[key];
+					evictExpired(key, idle, now);
+					if (!idle.empty()) {
+						auto session = std::move(idle.back().session);
+						idle.pop_back();
+						++totals_.hits;
+						++byOrigin_[key].hits;
+						return Lease(this, std::move(key), std::move(session));
+					}
+					++totals_.newConnections;
+					++byOrigin_[key].newConnections;
+				}
+				return Lease(this, std::move(key), createSession());
+			}
+
+			PoolStats stats() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				PoolStats s = totals_;
+				s.idle = 0;
+				for (const auto &[_, list]: idle_)
+					s.idle += list.size();
+				return s;
+			}
+
+			std::unordered_map<std::string, PoolStats> statsByOrigin() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto out = byOrigin_;
+				for (const auto &[key, list]: idle_)
+					out[key].idle = list.size();
+				return out;
+			}
+
+			// Closes every parked session; in-flight leases are unaffected.
+			void clear() {
+				std::lock_guard<std::mutex> lock(mtx_);
+				idle_.clear();
+			}
+
+		private:
+			struct IdleSession {
+				std::shared_ptr<cpr::Session> session;
+				std::chrono::steady_clock::time_point since;
+			};
+
+			ConnectionPool() {
+				share_ = curl_share_init();
+				if (share_) {
+					curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &ConnectionPool::lockShare);
+					curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &ConnectionPool::unlockShare);
+					curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+					curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+					curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+				}
+			}
+
+			~ConnectionPool() {
+				idle_.clear();
+				if (share_)
+					curl_share_cleanup(share_);
+			}
+
+			std::shared_ptr<cpr::Session> createSession() {
+				auto session = std::make_shared<cpr::Session>();
+				CURL *handle = session->GetCurlHolder()->handle;
+				curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+				curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, 30L);
+				curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, 15L);
+				if (share_)
+					curl_easy_setopt(handle, CURLOPT_SHARE, share_);
+				return session;
+			}
+
+			void release(const std::string &key, std::shared_ptr<cpr::Session> session) {
+				// Cookies are always sent explicitly per account; never let curl's
+				// cookie engine carry a Set-Cookie over to the next borrower.
+				curl_easy_setopt(session->GetCurlHolder()->handle, CURLOPT_COOKIELIST, "ALL");
+
+				auto now = std::chrono::steady_clock::now();
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto &idle = idle_[key];
+				evictExpired(key, idle, now);
+				if (idle.size() >= kMaxIdlePerOrigin) {
+					idle.pop_front();
+					++totals_.idleEvictions;
+					++byOrigin_[key].idleEvictions;
+				}
+				idle.push_back({std::move(session), now});
+			}
+
+			void evictExpired(
+				const std::string &key,
+				std::deque<IdleSession> &idle,
+				std::chrono::steady_clock::time_point now
+			) {
+				while (!idle.empty() && now - idle.front().since > kMaxIdleTime) {
+					idle.pop_front();
+					++totals_.idleEvictions;
+					++byOrigin_[key].idleEvictions;
+				}
+			}
+
+			static void lockShare(CURL *, curl_lock_data data, curl_lock_access, void *userptr) {
+				static_cast<ConnectionPool *>(userptr)->shareLocks_[data].lock();
+			}
+
+			static void unlockShare(CURL *, curl_lock_data data, void *userptr) {
+				static_cast<ConnectionPool *>(userptr)->shareLocks_[data].unlock();
+			}
+
+			mutable std::mutex mtx_;
+			std::unordered_map<std::string, std::deque<IdleSession> > idle_;
+			std::unordered_map<std::string, PoolStats> byOrigin_;
+			PoolStats totals_;
+
+			CURLSH *share_ = nullptr;
+			std::array<std::mutex, CURL_LOCK_DATA_LAST> shareLocks_;
+	};
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace HttpClient {
+	// Every *.rbxcdn.com host (t0-t7, tr, c0, ...) is throttled as one family.
+	inline constexpr const char *kCdnFamily = "rbxcdn.com";
+
+	// Groups a URL into the bucket it is throttled under: host plus the first
+	// path segment after the API version, e.g. "friends.roblox.com/users".
+	// CDN paths start with a per-file hash, so the CDN is a single family.
+	inline std::string endpointFamily(const std::string &url) {
+		size_t schemeEnd = url.find("://");
+		size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+		size_t pathStart = url.find_first_of("/?#", hostStart);
+		std::string host = url.substr(hostStart, pathStart - hostStart);
+		std::string_view cdn = kCdnFamily;
+		if (host == cdn || (host.size() > cdn.size() && host.ends_with(cdn) && host[host.size() - cdn.size() - 1] == '.'))
+			return kCdnFamily;
+		if (pathStart == std::string::npos || url[pathStart] != '/')
+			return host;
+
+		size_t pos = pathStart + 1;
+		while (pos < url.size()) {
+			size_t end = url.find_first_of("/?#", pos);
+			std::string segment = url.substr(pos, end - pos);
+			bool isVersion = segment.size() >= 2 && segment[0] == 'v' &&
+			                 std::all_of(segment.begin() + 1, segment.end(), ::isdigit);
+			if (!segment.empty() && !isVersion)
+				return host + "/" + segment;
+			if (end == std::string::npos || url[end] != '/')
+				break;
+			pos = end + 1;
+		}
+		return host;
+	}
+
+	// Parses a Retry-After header given in delta-seconds. HTTP-date values are
+	// not used by Roblox and fall back to the caller's own backoff.
+	inline std::chrono::milliseconds parseRetryAfter(const std::string &value) {
+		if (value.empty())
+			return std::chrono::milliseconds{0};
+		char *end = nullptr;
+		double seconds = std::strtod(value.c_str(), &end);
+		if (end == value.c_str() || seconds < 0)
+			return std::chrono::milliseconds{0};
+		return std::chrono::milliseconds{static_cast<long long>(seconds * 1000.0)};
+	}
+
+	// Full-jitter exponential backoff, never shorter than what the server asked for.
+	inline std::chrono::milliseconds backoffDelay(int attempt, std::chrono::milliseconds retryAfter) {
+		static thread_local std::mt19937 rng{std::random_device{}()};
+		long long cap = std::min<long long>(500LL << std::min(attempt, 6), 30000LL);
+		std::uniform_int_distribution<long long> dist(0, cap);
+		return std::max(retryAfter, std::chrono::milliseconds{dist(rng)});
+	}
+
+	inline bool isRetryableStatus(int status) {
+		return status == 429 || status == 503;
+	}
+
+	// Token bucket per endpoint family (implemented as GCRA so reservations can
+	// be handed out ahead of time). The sustained rate backs off multiplicatively
+	// on 429 and creeps back up on success, so long batches settle at the highest
+	// rate Roblox accepts instead of repeatedly tripping the limit.
+	class RateLimiter {
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			static constexpr int kMaxRetries = 4;
+
+			struct Limit {
+				double requestsPerSecond;
+				int burst;
+			};
+
+			struct FamilyStats {
+				double requestsPerSecond = 0;
+				size_t queued = 0;
+				uint64_t throttled = 0;
+			};
+
+			// Counts a request as queued until it is destroyed (i.e. until it starts).
+			class QueueSlot {
+				public:
+					QueueSlot() = default;
+					explicit QueueSlot(std::atomic<size_t> *counter) : counter_(counter) {
+						if (counter_) counter_->fetch_add(1, std::memory_order_relaxed);
+					}
+					QueueSlot(QueueSlot &&other) noexcept : counter_(other.counter_) { other.counter_ = nullptr; }
+					QueueSlot &operator=(QueueSlot &&other) noexcept {
+						if (this != &other) {
+							reset();
+							counter_ = other.counter_;
+							other.counter_ = nullptr;
+						}
+						return *this;
+					}
+					QueueSlot(const QueueSlot &) = delete;
+					QueueSlot &operator=(const QueueSlot &) = delete;
+					~QueueSlot() { reset(); }
+
+					void reset() {
+						if (counter_) counter_->fetch_sub(1, std::memory_order_relaxed);
+						counter_ = nullptr;
+					}
+
+				private:
+					std::atomic<size_t> *counter_ = nullptr;
+			};
+
+			struct Reservation {
+				Clock::time_point at;
+				QueueSlot slot;
+			};
+
+			static RateLimiter &instance() {
+				static RateLimiter limiter;
+				return limiter;
+			}
+
+			// Reserves the next send slot for `family`. The returned slot keeps the
+			// request counted in queueDepth() until it is released.
+			Reservation reserve(const std::string &family) {
+				auto now = Clock::now();
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto &state = stateFor(family);
+				auto interval = intervalFor(state.rate);
+				auto tolerance = interval * (state.limit.burst - 1);
+
+				if (state.tat < now)
+					state.tat = now;
+				auto at = std::max(now, state.tat - std::chrono::duration_cast<Clock::duration>(tolerance));
+				at = std::max(at, state.blockedUntil);
+				state.tat = std::max(state.tat, at) + std::chrono::duration_cast<Clock::duration>(interval);
+
+				if (at <= now)
+					return {at, QueueSlot{}};
+				return {at, QueueSlot{&state.queued}};
+			}
+
+			// Blocks the calling thread until `family` has capacity.
+			void acquire(const std::string &family) {
+				auto reservation = reserve(family);
+				if (reservation.at > Clock::now())
+					std::this_thread::sleep_until(reservation.at);
+			}
+
+			// Feeds a response back into the family's rate. `retryAfter` pauses the
+			// whole family, not just the request that hit it.
+			void onResponse(const std::string &family, int status, std::chrono::milliseconds retryAfter) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto &state = stateFor(family);
+				if (status == 429) {
+					++state.throttled;
+					state.rate = std::max(kMinRate, state.rate * 0.5);
+					auto pause = retryAfter.count() > 0 ? retryAfter : std::chrono::milliseconds{1000};
+					state.blockedUntil = std::max(state.blockedUntil, Clock::now() + pause);
+				} else if (status >= 200 && status < 400) {
+					state.rate = std::min(state.limit.requestsPerSecond, state.rate + kRecoveryStep);
+				}
+			}
+
+			void setLimit(const std::string &family, Limit limit) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto &state = stateFor(family);
+				state.limit = limit;
+				state.rate = limit.requestsPerSecond;
+			}
+
+			size_t queueDepth() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				size_t total = 0;
+				for (const auto &[_, state]: families_)
+					total += state.queued.load(std::memory_order_relaxed);
+				return total;
+			}
+
+			std::unordered_map<std::string, FamilyStats> snapshot() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				std::unordered_map<std::string, FamilyStats> out;
+				for (const auto &[family, state]: families_)
+					out[family] = {state.rate, state.queued.load(std::memory_order_relaxed), state.throttled};
+				return out;
+			}
+
+		private:
+			static constexpr double kMinRate = 0.2;
+			static constexpr double kRecoveryStep = 0.05;
+
+			struct State {
+				Limit limit{};
+				double rate = 0;
+				Clock::time_point tat{};
+				Clock::time_point blockedUntil{};
+				std::atomic<size_t> queued{0};
+				uint64_t throttled = 0;
+			};
+
+			// Idle families beyond this many are forgotten (see stateFor()).
+			static constexpr size_t kMaxFamilies = 256;
+
+			RateLimiter() = default;
+
+			static Limit defaultLimitFor(const std::string &family) {
+				// Static images; only the download concurrency cap applies in practice.
+				if (family == kCdnFamily)
+					return {50.0, 64};
+				// Auth and write-heavy social endpoints are the ones Roblox throttles hardest.
+				if (family.rfind("auth.", 0) == 0)
+					return {3.0, 3};
+				if (family.rfind("friends.", 0) == 0 || family.rfind("presence.", 0) == 0)
+					return {5.0, 10};
+				if (family.rfind("usermoderation.", 0) == 0)
+					return {5.0, 10};
+				return {10.0, 20};
+			}
+
+			static std::chrono::duration<double> intervalFor(double rate) {
+				return std::chrono::duration<double>(1.0 / std::max(rate, kMinRate));
+			}
+
+			State &stateFor(const std::string &family) {
+				auto it = families_.find(family);
+				if (it != families_.end())
+					return it->second;
+				if (families_.size() >= kMaxFamilies)
+					forgetIdleFamilies();
+				auto &state = families_[family];
+				state.limit = defaultLimitFor(family);
+				state.rate = state.limit.requestsPerSecond;
+				return state;
+			}
+
+			// Drops families with nothing queued, no pending pause, the default
+			// limit and their full rate back; a later request recreates them in
+			// that same state.
+			void forgetIdleFamilies() {
+				auto now = Clock::now();
+				std::erase_if(families_, [&](const auto &entry) {
+					const State &s = entry.second;
+					Limit def = defaultLimitFor(entry.first);
+					return s.queued.load(std::memory_order_relaxed) == 0 && s.tat <= now &&
+					       s.blockedUntil <= now && s.limit.requestsPerSecond == def.requestsPerSecond &&
+					       s.limit.burst == def.burst && s.rate >= s.limit.requestsPerSecond;
+				});
+			}
+
+			mutable std::mutex mtx_;
+			// Node-based so QueueSlots can keep pointers to the counters.
+			std::unordered_map<std::string, State> families_;
+	};
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace HttpClient {
+	// Scalar helpers for SAX field setters; a value of the wrong type reads as
+	// the default, as json::value() would return for a missing key.
+	inline std::string saxString(nlohmann::json &v) {
+		return v.is_string() ? std::move(v.get_ref<std::string &>()) : std::string();
+	}
+
+	inline uint64_t saxUint(const nlohmann::json &v) {
+		return v.is_number_unsigned() ? v.get<uint64_t>() : 0;
+	}
+
+	inline int saxInt(const nlohmann::json &v) {
+		return v.is_number_integer() ? v.get<int>() : 0;
+	}
+
+	inline double saxDouble(const nlohmann::json &v) {
+		return v.is_number() ? v.get<double>() : 0.0;
+	}
+
+	// Decodes the objects of one top-level array, e.g. "data" in Roblox's
+	// paged listings, straight into a vector<T> without building a DOM.
+	//
+	// `Item(T &, std::string_view path, nlohmann::json &value)` receives every
+	// scalar inside an element. `path` is relative to the element, with nested
+	// object keys joined by '.'; scalars in a nested array report the array's
+	// own path, once per element. `Top(std::string_view key, nlohmann::json &value)`
+	// receives the scalars of the root object, such as page cursors.
+	template<typename T, typename Item, typename Top>
+	class ArraySax : public nlohmann::json_sax<nlohmann::json> {
+		public:
+			ArraySax(std::string arrayKey, std::vector<T> &out, Item item, Top top) :
+				arrayKey_(std::move(arrayKey)), out_(out), item_(std::move(item)), top_(std::move(top)) {}
+
+			bool null() override { return scalar(nlohmann::json()); }
+			bool boolean(bool v) override { return scalar(nlohmann::json(v)); }
+			bool number_integer(number_integer_t v) override { return scalar(nlohmann::json(v)); }
+			bool number_unsigned(number_unsigned_t v) override { return scalar(nlohmann::json(v)); }
+			bool number_float(number_float_t v, const string_t &) override { return scalar(nlohmann::json(v)); }
+			bool string(string_t &v) override { return scalar(nlohmann::json(std::move(v))); }
+			bool binary(binary_t &) override { return true; }
+
+			bool key(string_t &k) override {
+				key_ = std::move(k);
+				return true;
+			}
+
+			bool start_object(std::size_t) override { return open(false); }
+			bool start_array(std::size_t) override { return open(true); }
+			bool end_object() override { return close(); }
+			bool end_array() override { return close(); }
+
+			bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override {
+				return false;
+			}
+
+		private:
+			struct Frame {
+				bool array;
+				std::size_t prefixLen;
+			};
+
+			bool inItem() const { return itemDepth_ != 0 && frames_.size() >= itemDepth_; }
+
+			bool open(bool array) {
+				bool parentIsObject = !frames_.empty() && !frames_.back().array;
+				if (!array && arrayDepth_ != 0 && frames_.size() == arrayDepth_) {
+					// An element of the target array.
+					frames_.push_back({false, prefix_.size()});
+					itemDepth_ = frames_.size();
+					prefix_.clear();
+					out_.emplace_back();
+					return true;
+				}
+				frames_.push_back({array, prefix_.size()});
+				if (array && frames_.size() == 2 && key_ == arrayKey_) {
+					arrayDepth_ = frames_.size();
+				} else if (inItem() && frames_.size() > itemDepth_ && parentIsObject) {
+					if (!prefix_.empty())
+						prefix_ += '.';
+					prefix_ += key_;
+				}
+				return true;
+			}
+
+			bool close() {
+				if (frames_.empty())
+					return false;
+				if (frames_.size() == itemDepth_)
+					itemDepth_ = 0;
+				if (frames_.size() == arrayDepth_)
+					arrayDepth_ = 0;
+				prefix_.resize(frames_.back().prefixLen);
+				frames_.pop_back();
+				return true;
+			}
+
+			bool scalar(nlohmann::json v) {
+				if (frames_.empty())
+					return true;
+				if (inItem()) {
+					if (frames_.back().array) {
+						item_(out_.back(), std::string_view(prefix_), v);
+					} else if (prefix_.empty()) {
+						item_(out_.back(), std::string_view(key_), v);
+					} else {
+						path_.assign(prefix_).append(1, '.').append(key_);
+						item_(out_.back(), std::string_view(path_), v);
+					}
+				} else if (frames_.size() == 1 && !frames_.back().array) {
+					top_(std::string_view(key_), v);
+				}
+				return true;
+			}
+
+			std::string arrayKey_;
+			std::vector<T> &out_;
+			Item item_;
+			Top top_;
+
+			std::vector<Frame> frames_;
+			std::size_t arrayDepth_ = 0; // frame depth of the target array, 0 outside it
+			std::size_t itemDepth_ = 0;  // frame depth of the current element, 0 outside one
+			std::string key_;
+			std::string prefix_;
+			std::string path_;
+	};
+
+	template<typename T, typename Item, typename Top>
+	ArraySax<T, Item, Top> makeArraySax(std::string arrayKey, std::vector<T> &out, Item item, Top top) {
+		return ArraySax<T, Item, Top>(std::move(arrayKey), out, std::move(item), std::move(top));
+	}
+
+	// Runs `handler` over a complete document; false if it was malformed.
+	template<typename Handler>
+	bool saxParse(std::string_view body, Handler &handler) {
+		return nlohmann::json::sax_parse(body.begin(), body.end(), &handler);
+	}
+}
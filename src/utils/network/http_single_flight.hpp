@@ -0,0 +1,98 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace HttpClient {
+	// Collapses concurrent work on the same key into one execution: the first
+	// caller becomes the leader and does the work, everyone who joins while it
+	// is still running gets the leader's result through their own callback.
+	template<typename T>
+	class SingleFlight {
+		public:
+			using Result = std::shared_ptr<const T>;
+			using Waiter = std::function<void(Result)>;
+
+			// Registers `waiter` for `key`. Returns true when the caller is the
+			// leader and must eventually call complete(key, ...).
+			bool join(const std::string &key, Waiter waiter) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto [it, inserted] = waiting_.try_emplace(key);
+				it->second.push_back(std::move(waiter));
+				if (!inserted)
+					++coalesced_;
+				return inserted;
+			}
+
+			void complete(const std::string &key, Result result) {
+				std::vector<Waiter> waiters; {
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto it = waiting_.find(key);
+					if (it == waiting_.end())
+						return;
+					waiters = std::move(it->second);
+					waiting_.erase(it);
+				}
+				for (auto &w: waiters)
+					w(result);
+			}
+
+			// Blocking helper: runs `work` unless an identical call is already in
+			// flight, in which case it waits for and shares that call's result.
+			template<typename Fn>
+			Result run(const std::string &key, Fn &&work) {
+				std::mutex m;
+				std::condition_variable cv;
+				Result out;
+				bool ready = false;
+				bool leader = join(key, [&](Result r) {
+					std::lock_guard<std::mutex> lk(m);
+					out = std::move(r);
+					ready = true;
+					cv.notify_one();
+				});
+				if (leader) {
+					Result r;
+					try {
+						// Built non-const so a sole owner may move out of it (see takeResult).
+						r = std::make_shared<T>(work());
+					} catch (...) {
+						complete(key, nullptr);
+						throw;
+					}
+					complete(key, std::move(r));
+				}
+				std::unique_lock<std::mutex> lk(m);
+				cv.wait(lk, [&] { return ready; });
+				return out;
+			}
+
+			uint64_t coalesced() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return coalesced_;
+			}
+
+		private:
+			mutable std::mutex mtx_;
+			std::unordered_map<std::string, std::vector<Waiter> > waiting_;
+			uint64_t coalesced_ = 0;
+	};
+
+	// Hands a run() result to its caller: moved out when nobody else shares it
+	// (the common, uncoalesced case), cloned otherwise.
+	template<typename T>
+	T takeResult(std::shared_ptr<const T> r) {
+		if (!r)
+			return T{};
+		if (r.use_count() == 1)
+			return std::move(const_cast<T &>(*r));
+		return r->clone();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace HttpClient {
+	// Hands body chunks from the I/O thread to a reader on another thread as a
+	// std::streambuf, so a parser can consume a response while it downloads.
+	// Only chunks not yet read are held in memory.
+	class ChunkPipe : public std::streambuf {
+		public:
+			// Returns false once the reader has gone away, aborting the transfer.
+			bool push(std::string_view chunk) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				if (abandoned_)
+					return false;
+				if (!chunk.empty()) {
+					chunks_.emplace_back(chunk);
+					cv_.notify_one();
+				}
+				return true;
+			}
+
+			void close() {
+				std::lock_guard<std::mutex> lock(mtx_);
+				closed_ = true;
+				cv_.notify_one();
+			}
+
+			// Called by the reader when it stops early; drops anything queued.
+			void abandon() {
+				std::lock_guard<std::mutex> lock(mtx_);
+				abandoned_ = true;
+				chunks_.clear();
+			}
+
+		protected:
+			int_type underflow() override {
+				if (gptr() < egptr())
+					return traits_type::to_int_type(*gptr());
+				std::unique_lock<std::mutex> lock(mtx_);
+				cv_.wait(lock, [this] { return !chunks_.empty() || closed_; });
+				if (chunks_.empty())
+					return traits_type::eof();
+				current_ = std::move(chunks_.front());
+				chunks_.pop_front();
+				setg(current_.data(), current_.data(), current_.data() + current_.size());
+				return traits_type::to_int_type(*gptr());
+			}
+
+		private:
+			std::mutex mtx_;
+			std::condition_variable cv_;
+			std::deque<std::string> chunks_;
+			std::string current_;
+			bool closed_ = false;
+			bool abandoned_ = false;
+	};
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <nlohmann/json.hpp>
+#include <cpr/cpr.h>
+
+#include "core/logging.hpp"
+#include "http_async.hpp"
+#include "http_pool.hpp"
+#include "http_rate_limit.hpp"
+#include "http_types.hpp"
+#include "system/timers.h"
+
+namespace HttpClient {
+	inline Response toResponse(cpr::Response &&r) {
+		return {static_cast<int>(r.status_code), std::move(r.text), std::move(r.header)};
+	}
+
+	inline void applyRequest(cpr::Session &session, const Request &req) {
+		session.SetUrl(cpr::Url{req.url});
+		session.SetHeader(req.headers);
+		session.SetParameters(req.params);
+		// Always reset the body so a pooled POST session never replays the previous one.
+		if (req.method != "GET")
+			session.SetBody(cpr::Body{req.body});
+		// Installed on every request, since a pooled session keeps the previous
+		// borrower's callback. libcurl polls it at least once a second, so a
+		// cancelled or overdue transfer stops promptly even when stalled.
+		session.SetProgressCallback(cpr::ProgressCallback{
+			[ctx = req.context](cpr::cpr_pf_arg_t, cpr::cpr_pf_arg_t, cpr::cpr_pf_arg_t, cpr::cpr_pf_arg_t, intptr_t) {
+				return !ctx.expired();
+			}
+		});
+	}
+
+	// The wire underneath send()/sendAsync(). Rate limiting, retries, the cache
+	// and single-flight all sit above it, so swapping the transport exercises the
+	// whole client against recorded or synthetic responses.
+	class Transport : public std::enable_shared_from_this<Transport> {
+		public:
+			virtual ~Transport() = default;
+
+			virtual Response perform(const Request &req) = 0;
+
+			// Must not start before `notBefore`; `slot` is released once it starts.
+			// `done` may run on an internal thread and must stay short.
+			virtual void performAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				Callback done
+			) = 0;
+
+			// Like performAsync(), but a 2xx body goes to `sink` piece by piece
+			// instead of into Response::text. Non-2xx bodies are still buffered.
+			// The default feeds the buffered body to the sink in one piece.
+			virtual void performStreamAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				ChunkSink sink,
+				Callback done
+			) {
+				performAsync(
+					std::move(req), notBefore, std::move(slot),
+					[sink = std::move(sink), done = std::move(done)](Response r) {
+						if (r.status_code >= 200 && r.status_code < 300) {
+							sink(r.text);
+							r.text.clear();
+						}
+						done(std::move(r));
+					});
+			}
+
+			// False for transports that never reach Roblox. Their responses are
+			// kept out of the on-disk HTTP cache.
+			virtual bool live() const { return true; }
+
+			virtual const char *name() const = 0;
+	};
+
+	class LiveTransport : public Transport {
+		public:
+			Response perform(const Request &req) override {
+				auto lease = ConnectionPool::instance().acquire(req.url, req.method.c_str());
+				applyRequest(lease.session(), req);
+				cpr::Response r = req.method == "GET" ? lease.session().Get() : lease.session().Post();
+				// A session whose transfer failed may hold a broken connection.
+				if (r.error || r.status_code == 0)
+					lease.discard();
+				return toResponse(std::move(r));
+			}
+
+			void performAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				Callback done
+			) override {
+				auto lease = ConnectionPool::instance().acquire(req->url, req->method.c_str());
+				applyRequest(lease.session(), *req);
+				IoLoop::instance().submit(
+					std::move(lease),
+					[isGet = req->method == "GET"](cpr::Session &session) {
+						if (isGet)
+							session.PrepareGet();
+						else
+							session.PreparePost();
+					},
+					[done = std::move(done)](cpr::Response r) { done(toResponse(std::move(r))); },
+					notBefore,
+					std::move(slot));
+			}
+
+			// Streaming sessions live in their own pool lane because the write
+			// callback stays installed on the session after it is returned.
+			void performStreamAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				ChunkSink sink,
+				Callback done
+			) override {
+				bool isGet = req->method == "GET";
+				auto lease = ConnectionPool::instance().acquire(req->url, isGet ? "GET-STREAM" : "POST-STREAM");
+				applyRequest(lease.session(), *req);
+				CURL *handle = lease.session().GetCurlHolder()->handle;
+				auto errorBody = std::make_shared<std::string>();
+				lease.session().SetWriteCallback(cpr::WriteCallback{
+					[handle, errorBody, sink = std::move(sink)](const std::string_view &data, intptr_t) {
+						long code = 0;
+						curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &code);
+						if (code >= 200 && code < 300)
+							return sink(data);
+						errorBody->append(data);
+						return true;
+					}
+				});
+				IoLoop::instance().submit(
+					std::move(lease),
+					[isGet](cpr::Session &session) {
+						if (isGet)
+							session.PrepareGet();
+						else
+							session.PreparePost();
+					},
+					[errorBody, done = std::move(done)](cpr::Response r) {
+						Response out = toResponse(std::move(r));
+						if (out.status_code < 200 || out.status_code >= 300)
+							out.text = std::move(*errorBody);
+						done(std::move(out));
+					},
+					notBefore,
+					std::move(slot));
+			}
+
+			const char *name() const override { return "live"; }
+	};
+
+	// Base for transports that answer in-process: perform() computes the reply on
+	// the caller's thread, performAsync() from a timer after `delay()`, so rate
+	// limit reservations and simulated latency never park a thread per request.
+	class LocalTransport : public Transport {
+		public:
+			void performAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				Callback done
+			) override {
+				auto start = std::max(notBefore, std::chrono::steady_clock::now());
+				auto held = std::make_shared<RateLimiter::QueueSlot>(std::move(slot));
+				auto self = std::static_pointer_cast<LocalTransport>(shared_from_this());
+				Timers::at(start + delay(), [self, req, held, done = std::move(done)] {
+					held->reset();
+					done(req->context.expired() ? Response{} : self->respond(*req));
+				});
+			}
+
+			Response perform(const Request &req) override {
+				std::this_thread::sleep_for(delay());
+				return respond(req);
+			}
+
+			bool live() const override { return false; }
+
+		protected:
+			virtual Response respond(const Request &req) = 0;
+
+			virtual std::chrono::milliseconds delay() { return std::chrono::milliseconds{0}; }
+	};
+
+	// Fixtures are keyed by method, URL, query, body and a digest of the Cookie
+	// header, so per-account endpoints recorded for several accounts do not
+	// overwrite each other. Replays need the same accounts signed in.
+	inline std::string fixtureKey(const Request &req) {
+		std::string key = req.method + ' ' + req.url;
+		std::string query = queryOf(req);
+		if (!query.empty())
+			key += '?' + query;
+		if (!req.body.empty())
+			key += '\n' + req.body;
+		auto cookie = req.headers.find("Cookie");
+		if (cookie != req.headers.end() && !cookie->second.empty()) {
+			std::ostringstream digest;
+			digest << std::hex << fnv1a(cookie->second);
+			key += "\ncookie:" + digest.str();
+		}
+		return key;
+	}
+
+	// Credentials that must never reach a fixture file: these response headers
+	// are dropped, and exchanges with these endpoints are not recorded at all.
+	inline bool isCredentialHeader(const std::string &lowerName) {
+		return lowerName == "set-cookie" || lowerName == "rbx-authentication-ticket" ||
+		       lowerName == "x-csrf-token";
+	}
+
+	inline bool isCredentialEndpoint(const std::string &url) {
+		return url.find("auth.roblox.com/v1/authentication-ticket") != std::string::npos ||
+		       url.find("users.roblox.com/v1/users/authenticated") != std::string::npos;
+	}
+
+	inline std::filesystem::path fixturePath(const std::filesystem::path &dir, const Request &req) {
+		std::ostringstream ss;
+		ss << std::hex << fnv1a(fixtureKey(req)) << ".json";
+		return dir / ss.str();
+	}
+
+	// Forwards to the live transport and writes every exchange to `dir` as one
+	// JSON file, ready for ReplayTransport. Credentials are never written out;
+	// see isCredentialHeader() and isCredentialEndpoint().
+	class RecordingTransport : public Transport {
+		public:
+			explicit RecordingTransport(std::filesystem::path dir) : dir_(std::move(dir)) {
+				std::error_code ec;
+				std::filesystem::create_directories(dir_, ec);
+			}
+
+			Response perform(const Request &req) override {
+				Response resp = inner_.perform(req);
+				save(req, resp);
+				return resp;
+			}
+
+			void performAsync(
+				std::shared_ptr<const Request> req,
+				std::chrono::steady_clock::time_point notBefore,
+				RateLimiter::QueueSlot slot,
+				Callback done
+			) override {
+				auto self = std::static_pointer_cast<RecordingTransport>(shared_from_this());
+				inner_.performAsync(req, notBefore, std::move(slot), [self, req, done = std::move(done)](Response r) {
+					self->save(*req, r);
+					done(std::move(r));
+				});
+			}
+
+			const char *name() const override { return "record"; }
+
+		private:
+			void save(const Request &req, const Response &resp) {
+				// Transport failures and throttling are not worth replaying.
+				if (resp.status_code == 0 || resp.status_code == 429 || isCredentialEndpoint(req.url))
+					return;
+				nlohmann::json headers = nlohmann::json::object();
+				for (const auto &[k, v]: resp.headers) {
+					std::string lower = k;
+					std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {
+						return static_cast<char>(std::tolower(c));
+					});
+					if (!isCredentialHeader(lower) && lower != "content-encoding" && lower != "content-length")
+						headers[lower] = v;
+				}
+				nlohmann::json j = {
+					{"key", fixtureKey(req)},
+					{"status", resp.status_code},
+					{"headers", headers},
+					{"body", resp.text}
+				};
+				std::lock_guard<std::mutex> lock(mtx_);
+				std::ofstream out(fixturePath(dir_, req), std::ios::trunc);
+				if (out.is_open())
+					out << j.dump(1, '\t');
+			}
+
+			LiveTransport inner_;
+			std::filesystem::path dir_;
+			std::mutex mtx_;
+	};
+
+	// Serves exchanges captured by RecordingTransport. Unknown requests get a
+	// 404 so missing fixtures show up in the log instead of hanging a caller.
+	class ReplayTransport : public LocalTransport {
+		public:
+			explicit ReplayTransport(std::filesystem::path dir) : dir_(std::move(dir)) {}
+
+			const char *name() const override { return "replay"; }
+
+		protected:
+			Response respond(const Request &req) override {
+				std::ifstream in(fixturePath(dir_, req));
+				if (!in.is_open()) {
+					LOG_ERROR("No fixture for " + fixtureKey(req));
+					return {404, "{}", {}};
+				}
+				try {
+					nlohmann::json j;
+					in >> j;
+					Response r{j.value("status", 0), j.value("body", ""), {}};
+					for (auto &[k, v]: j.value("headers", nlohmann::json::object()).items())
+						r.headers[k] = v.get<std::string>();
+					return r;
+				} catch (const std::exception &e) {
+					LOG_ERROR(std::string("Corrupt fixture for ") + req.url + ": " + e.what());
+					return {};
+				}
+			}
+
+		private:
+			std::filesystem::path dir_;
+	};
+
+	namespace detail {
+		inline std::mutex &transportMutex() {
+			static std::mutex m;
+			return m;
+		}
+
+		inline std::shared_ptr<Transport> &transportSlot() {
+			static std::shared_ptr<Transport> t = std::make_shared<LiveTransport>();
+			return t;
+		}
+	}
+
+	// Requests already in flight keep the transport they started on.
+	inline std::shared_ptr<Transport> transport() {
+		std::lock_guard<std::mutex> lock(detail::transportMutex());
+		return detail::transportSlot();
+	}
+
+	inline void setTransport(std::shared_ptr<Transport> t) {
+		std::lock_guard<std::mutex> lock(detail::transportMutex());
+		detail::transportSlot() = std::move(t);
+		LOG_INFO(std::string("HTTP transport: ") + detail::transportSlot()->name());
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cpr/cpr.h>
+
+#include "http_cancel.hpp"
+
+namespace HttpClient {
+	// Move-only so bodies and headers are handed along instead of copied;
+	// use clone() where a second copy is really needed. Header lookups are
+	// case-insensitive (cpr::Header compares names that way).
+	struct Response {
+		int status_code = 0;
+		std::string text;
+		cpr::Header headers;
+
+		Response() = default;
+
+		Response(int status, std::string body, cpr::Header hdrs = {}) :
+			status_code(status), text(std::move(body)), headers(std::move(hdrs)) {}
+
+		Response(Response &&) noexcept = default;
+		Response &operator=(Response &&) noexcept = default;
+		Response(const Response &) = delete;
+		Response &operator=(const Response &) = delete;
+
+		Response clone() const { return {status_code, text, headers}; }
+	};
+
+	inline std::string build_kv_string(
+		std::initializer_list<std::pair<const std::string, std::string> > items,
+		char sep = '&'
+	) {
+		std::ostringstream ss;
+		bool first = true;
+		for (auto &kv: items) {
+			if (!first) ss << sep;
+			first = false;
+			ss << kv.first << '=' << kv.second;
+		}
+		return ss.str();
+	}
+
+	using HeaderList = std::initializer_list<std::pair<const std::string, std::string> >;
+	using Callback = std::function<void(Response)>;
+	// Receives successive (already decompressed) pieces of a 2xx body. Return
+	// false to abort the transfer.
+	using ChunkSink = std::function<bool(std::string_view)>;
+
+	// A fully materialised request, so it can be re-sent after a 429 or handed to
+	// the I/O thread after the caller's initializer lists are gone.
+	struct Request {
+		std::string method;
+		std::string url;
+		cpr::Header headers;
+		cpr::Parameters params;
+		std::string body;
+		// Taken from the RequestScope active when the request was made.
+		RequestContext context;
+	};
+
+	inline Request makeGet(const std::string &url, HeaderList headers, cpr::Parameters params) {
+		return {"GET", url, cpr::Header{headers}, std::move(params), {}, currentRequestContext()};
+	}
+
+	inline Request makePost(const std::string &url, HeaderList headers, const std::string &jsonBody, HeaderList form) {
+		Request req{"POST", url, cpr::Header{headers}, {}, {}, currentRequestContext()};
+		if (!jsonBody.empty()) {
+			req.headers["Content-Type"] = "application/json";
+			req.body = jsonBody;
+		} else if (form.size() > 0) {
+			req.headers["Content-Type"] = "application/x-www-form-urlencoded";
+			req.body = build_kv_string(form);
+		}
+		return req;
+	}
+
+	// Encoded query string of `req.params` (without the leading '?').
+	inline std::string queryOf(const Request &req) {
+		static thread_local cpr::CurlHolder holder;
+		return req.params.GetContent(holder);
+	}
+
+	inline const std::string *findHeader(const Response &r, const std::string &name) {
+		auto it = r.headers.find(name);
+		return it == r.headers.end() ? nullptr : &it->second;
+	}
+
+	// 64-bit FNV-1a, used wherever a key has to be turned into a file name or
+	// map key without keeping the original (cookies, request keys).
+	inline uint64_t fnv1a(std::string_view data) {
+		uint64_t h = 1469598103934665603ULL;
+		for (unsigned char c: data) {
+			h ^= c;
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+}
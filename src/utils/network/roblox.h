@@ -1,8 +1,13 @@
 #pragma once
 
 #include "roblox/common.h"
+#include "roblox/csrf.h"
 #include "roblox/auth.h"
 #include "roblox/games.h"
+#include "roblox/server_crawler.h"
+#include "roblox/ticket_pool.h"
 #include "roblox/session.h"
 #include "roblox/social.h"
+#include "roblox/thumbnails.h"
+#include "roblox/mock_transport.h"
 
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
-#include <mutex>
 #include <nlohmann/json.hpp>
 
 #include "http.hpp"
+#include "csrf.h"
 #include "core/logging.hpp"
 #include "core/time_utils.h"
 #include "status.h"
@@ -28,8 +34,82 @@ namespace Roblox {
 	};
 
 	// Cache for ban check results so we don't hit the endpoint repeatedly.
-	inline std::mutex g_banStatusMutex;
-	inline std::unordered_map<std::string, BanCheckResult> g_banStatusCache;
+	// Keyed by cookie digest; how long a result is trusted depends on what it
+	// was, and a timed ban is dropped once its endDate has passed.
+	class BanStatusCache {
+		public:
+			static constexpr size_t kMaxEntries = 1024;
+
+			std::optional<BanCheckResult> get(const std::string &cookie) const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				auto it = entries_.find(cookieDigest(cookie));
+				if (it == entries_.end() || std::chrono::steady_clock::now() >= it->second.expires)
+					return std::nullopt;
+				return it->second.status;
+			}
+
+			void put(const std::string &cookie, const BanInfo &info) {
+				auto now = std::chrono::steady_clock::now();
+				auto expires = now + ttlFor(info.status);
+				if (info.status == BanCheckResult::Banned && info.endDate > 0) {
+					auto left = std::chrono::seconds(std::max<time_t>(0, info.endDate - std::time(nullptr)));
+					expires = std::min(expires, now + left);
+				}
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				entries_[cookieDigest(cookie)] = {info.status, expires};
+				if (entries_.size() > kMaxEntries)
+					evict(now);
+			}
+
+			void erase(const std::string &cookie) {
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				entries_.erase(cookieDigest(cookie));
+			}
+
+			size_t size() const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				return entries_.size();
+			}
+
+		private:
+			struct Entry {
+				BanCheckResult status;
+				std::chrono::steady_clock::time_point expires;
+			};
+
+			static std::chrono::seconds ttlFor(BanCheckResult status) {
+				using namespace std::chrono_literals;
+				switch (status) {
+					case BanCheckResult::Unbanned: return 10min;
+					case BanCheckResult::Warned: return 5min; // cleared as soon as it is acknowledged
+					case BanCheckResult::Banned: return 30min;
+					case BanCheckResult::Terminated: return 1h;
+					case BanCheckResult::InvalidCookie: return 1min; // also what a failed request reports
+				}
+				return 1min;
+			}
+
+			// Drops expired entries, then the ones closest to expiring until
+			// the map is back under its bound.
+			void evict(std::chrono::steady_clock::time_point now) {
+				for (auto it = entries_.begin(); it != entries_.end();)
+					it = now >= it->second.expires ? entries_.erase(it) : std::next(it);
+				while (entries_.size() > kMaxEntries) {
+					auto victim = std::min_element(entries_.begin(), entries_.end(), [](const auto &a, const auto &b) {
+						return a.second.expires < b.second.expires;
+					});
+					entries_.erase(victim);
+				}
+			}
+
+			mutable std::shared_mutex mtx_;
+			std::unordered_map<uint64_t, Entry> entries_;
+	};
+
+	inline BanStatusCache &banStatusCache() {
+		static BanStatusCache cache;
+		return cache;
+	}
 
 	static BanInfo checkBanStatus(const std::string &cookie) {
 		LOG_INFO("Checking moderation status");
@@ -71,27 +151,24 @@ namespace Roblox {
 		return {BanCheckResult::Unbanned, 0};
 	}
 
-	static BanCheckResult cachedBanStatus(const std::string &cookie) { {
-			std::lock_guard<std::mutex> lock(g_banStatusMutex);
-			auto it = g_banStatusCache.find(cookie);
-			if (it != g_banStatusCache.end())
-				return it->second;
-		}
+	static BanCheckResult cachedBanStatus(const std::string &cookie) {
+		if (auto cached = banStatusCache().get(cookie))
+			return *cached;
 
-		BanCheckResult status = checkBanStatus(cookie).status; {
-			std::lock_guard<std::mutex> lock(g_banStatusMutex);
-			g_banStatusCache[cookie] = status;
-		}
-		return status;
+		BanInfo info = checkBanStatus(cookie);
+		banStatusCache().put(cookie, info);
+		return info.status;
+	}
+
+	// Force refresh the cached ban status for a cookie, keeping the full result
+	static BanInfo refreshBanInfo(const std::string &cookie) {
+		BanInfo info = checkBanStatus(cookie);
+		banStatusCache().put(cookie, info);
+		return info;
 	}
 
-	// Force refresh the cached ban status for a cookie
 	static BanCheckResult refreshBanStatus(const std::string &cookie) {
-		BanCheckResult status = checkBanStatus(cookie).status; {
-			std::lock_guard<std::mutex> lock(g_banStatusMutex);
-			g_banStatusCache[cookie] = status;
-		}
-		return status;
+		return refreshBanInfo(cookie).status;
 	}
 
 
@@ -138,46 +215,31 @@ namespace Roblox {
 	}
 
 
-	static std::string fetchAuthTicket(const std::string &cookie) {
-		if (!canUseCookie(cookie))
-			return "";
-		LOG_INFO("Fetching x-csrf token");
-		std::cout << cookie;
-		auto csrfResponse = HttpClient::post(
-			"https://auth.roblox.com/v1/authentication-ticket",
-			{{"Cookie", ".ROBLOSECURITY=" + cookie}});
-
-		auto csrfToken = csrfResponse.headers.find("x-csrf-token");
-		if (csrfToken == csrfResponse.headers.end()) {
-			std::cerr << "failed to get CSRF token\n";
-
-			LOG_INFO("Failed to get CSRF token");
-			return "";
-		}
-
+	// Mints an rbx-authentication-ticket for launching the client. Does not run
+	// the moderation check; callers that need it use fetchAuthTicket.
+	static std::string requestAuthTicket(const std::string &cookie) {
 		LOG_INFO("Fetching authentication ticket");
-		auto ticketResponse = HttpClient::post(
-			"https://auth.roblox.com/v1/authentication-ticket",
-			{
-				{"Cookie", ".ROBLOSECURITY=" + cookie},
-				{"Origin", "https://www.roblox.com"},
-				{"Referer", "https://www.roblox.com/"},
-				{"X-CSRF-TOKEN", csrfToken->second}
-			});
+		auto ticketResponse = authedPost("https://auth.roblox.com/v1/authentication-ticket", cookie);
 
 		if (ticketResponse.status_code < 200 || ticketResponse.status_code >= 300) {
 			LOG_ERROR("Failed to fetch auth ticket: HTTP " + std::to_string(ticketResponse.status_code));
 			return "";
 		}
 
-		auto ticket = ticketResponse.headers.find("rbx-authentication-ticket");
-		if (ticket == ticketResponse.headers.end()) {
+		auto ticket = HttpClient::findHeader(ticketResponse, "rbx-authentication-ticket");
+		if (!ticket) {
 			std::cerr << "failed to get authentication ticket\n";
 			LOG_INFO("Failed to get authentication ticket");
 			return "";
 		}
 
-		return ticket->second;
+		return *ticket;
+	}
+
+	static std::string fetchAuthTicket(const std::string &cookie) {
+		if (!canUseCookie(cookie))
+			return "";
+		return requestAuthTicket(cookie);
 	}
 
 	static uint64_t getUserId(const std::string &cookie) {
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "http.hpp"
+
+namespace Roblox {
+	// 64-bit FNV-1a of a cookie, so per-account caches never hold the raw
+	// .ROBLOSECURITY value as a key.
+	inline uint64_t cookieDigest(std::string_view cookie) {
+		return HttpClient::fnv1a(cookie);
+	}
+
+	// Last x-csrf-token Roblox issued for each cookie. Tokens stay valid across
+	// many writes, so they are reused until a request is rejected with 403.
+	class CsrfTokenStore {
+		public:
+			std::string get(const std::string &cookie) const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				auto it = tokens_.find(cookieDigest(cookie));
+				return it == tokens_.end() ? std::string{} : it->second;
+			}
+
+			void set(const std::string &cookie, const std::string &token) {
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				tokens_[cookieDigest(cookie)] = token;
+			}
+
+			void invalidate(const std::string &cookie) {
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				tokens_.erase(cookieDigest(cookie));
+			}
+
+		private:
+			mutable std::shared_mutex mtx_;
+			std::unordered_map<uint64_t, std::string> tokens_;
+	};
+
+	inline CsrfTokenStore &csrfTokens() {
+		static CsrfTokenStore store;
+		return store;
+	}
+
+	// POSTs on behalf of `cookie` with the cached CSRF token. When Roblox rejects
+	// the token (403 carrying a new x-csrf-token) the new one is stored and the
+	// request is sent once more, so a warm cookie costs one round trip per write.
+	inline HttpClient::Response authedPost(
+		const std::string &url,
+		const std::string &cookie,
+		const std::string &jsonBody = std::string()
+	) {
+		HttpClient::Response resp;
+		for (int attempt = 0; attempt < 2; ++attempt) {
+			std::string sent = csrfTokens().get(cookie);
+			resp = HttpClient::post(
+				url,
+				{
+					{"Cookie", ".ROBLOSECURITY=" + cookie},
+					{"Origin", "https://www.roblox.com"},
+					{"Referer", "https://www.roblox.com/"},
+					{"X-CSRF-TOKEN", sent}
+				},
+				jsonBody);
+
+			if (resp.status_code != 403)
+				break;
+			// A 403 without a different token is a real refusal, not a stale token.
+			auto token = HttpClient::findHeader(resp, "x-csrf-token");
+			if (!token || token->empty() || *token == sent)
+				break;
+			csrfTokens().set(cookie, *token);
+		}
+		return resp;
+	}
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -32,53 +35,81 @@ namespace Roblox {
                 bool creatorVerified = false;
         };
 
-	inline GameDetail getGameDetail(uint64_t universeId) {
-		using nlohmann::json;
-		const std::string url =
-				"https://games.roblox.com/v1/games?universeIds=" + std::to_string(universeId);
+	inline GameDetail parseGameDetail(const nlohmann::json &j) {
+		GameDetail d;
+		d.name = j.value("name", "");
+		d.genre = j.value("genre", "");
+		d.genreL1 = j.value("genre_l1", "");
+		d.genreL2 = j.value("genre_l2", "");
+		d.description = j.value("description", "");
+		d.visits = j.value("visits", 0ULL);
+		d.favorites = j.value("favoritedCount", 0ULL);
+		d.playing = j.value("playing", 0);
+		d.maxPlayers = j.value("maxPlayers", 0);
+		// price can be null; handle as -1 when not present
+		if (j.contains("price") && !j["price"].is_null()) {
+			d.priceRobux = j["price"].get<int>();
+		} else {
+			d.priceRobux = -1;
+		}
+		d.createdIso = j.value("created", "");
+		d.updatedIso = j.value("updated", "");
+
+		if (j.contains("creator")) {
+			const auto &c = j["creator"];
+			d.creatorName = c.value("name", "");
+			d.creatorId = c.value("id", 0ULL);
+			d.creatorType = c.value("type", "");
+			d.creatorVerified = c.value("hasVerifiedBadge", false);
+		}
+		return d;
+	}
 
-                HttpClient::Response resp = HttpClient::get(url);
-                if (resp.status_code < 200 || resp.status_code >= 300) {
-                        LOG_ERROR("Game detail fetch failed: HTTP " + std::to_string(resp.status_code));
-                        return GameDetail{};
-                }
+	// Details for many universes, 50 per request (the endpoint's limit).
+	// `live` asks Roblox even when the cached copy is still valid, for
+	// refreshing player counts; the answer updates the cache.
+	inline std::unordered_map<uint64_t, GameDetail> getGameDetails(
+		const std::vector<uint64_t> &universeIds,
+		bool live = false
+	) {
+		constexpr size_t kBatchSize = 50;
+		std::unordered_map<uint64_t, GameDetail> out;
+		for (size_t i = 0; i < universeIds.size(); i += kBatchSize) {
+			size_t end = (std::min)(universeIds.size(), i + kBatchSize);
+			std::string url = "https://games.roblox.com/v1/games?universeIds=";
+			for (size_t k = i; k < end; ++k) {
+				if (k != i)
+					url += ',';
+				url += std::to_string(universeIds[k]);
+			}
 
-		GameDetail d;
-		try {
-			json root = json::parse(resp.text);
-			if (root.contains("data") && root["data"].is_array() && !root["data"].empty()) {
-				const auto &j = root["data"][0];
-                        d.name = j.value("name", "");
-                        d.genre = j.value("genre", "");
-                        d.genreL1 = j.value("genre_l1", "");
-                        d.genreL2 = j.value("genre_l2", "");
-                        d.description = j.value("description", "");
-                        d.visits = j.value("visits", 0ULL);
-                        d.favorites = j.value("favoritedCount", 0ULL);
-                        d.playing = j.value("playing", 0);
-                        d.maxPlayers = j.value("maxPlayers", 0);
-                        // price can be null; handle as -1 when not present
-                        if (j.contains("price") && !j["price"].is_null()) {
-                                d.priceRobux = j["price"].get<int>();
-                        } else {
-                                d.priceRobux = -1;
-                        }
-                        d.createdIso = j.value("created", "");
-                        d.updatedIso = j.value("updated", "");
-
-                        if (j.contains("creator")) {
-					const auto &c = j["creator"];
-                                d.creatorName = c.value("name", "");
-                                d.creatorId = c.value("id", 0ULL);
-                                d.creatorType = c.value("type", "");
-					d.creatorVerified = c.value("hasVerifiedBadge", false);
+			// Shared with any identical lookup already in flight (same parsed document).
+			auto resp = HttpClient::getJson(url, {}, {}, live);
+			if (resp->status_code < 200 || resp->status_code >= 300) {
+				LOG_ERROR("Game detail fetch failed: HTTP " + std::to_string(resp->status_code));
+				continue;
+			}
+
+			try {
+				const auto &root = resp->body;
+				if (root.contains("data") && root["data"].is_array()) {
+					for (const auto &j: root["data"]) {
+						uint64_t id = j.value("id", 0ULL);
+						if (id != 0)
+							out[id] = parseGameDetail(j);
+					}
 				}
+			} catch (const std::exception &e) {
+				LOG_ERROR(std::string("Failed to parse game detail: ") + e.what());
 			}
-		} catch (const std::exception &e) {
-			LOG_ERROR(std::string("Failed to parse game detail: ") + e.what());
 		}
+		return out;
+	}
 
-		return d;
+	inline GameDetail getGameDetail(uint64_t universeId) {
+		auto details = getGameDetails({universeId});
+		auto it = details.find(universeId);
+		return it == details.end() ? GameDetail{} : std::move(it->second);
 	}
 
 	struct ServerPage {
@@ -87,21 +118,12 @@ namespace Roblox {
 		std::string prevCursor;
 	};
 
-	static ServerPage getPublicServersPage(uint64_t placeId,
-	                                       const std::string &cursor = {}) {
-		std::string url =
-				"https://games.roblox.com/v1/games/" + std::to_string(placeId) +
-				"/servers/Public?sortOrder=Asc&limit=100" +
-				(cursor.empty() ? "" : "&cursor=" + cursor);
-
-                HttpClient::Response resp = HttpClient::get(url);
-                if (resp.status_code < 200 || resp.status_code >= 300) {
-                        LOG_ERROR("Failed to fetch servers: HTTP " + std::to_string(resp.status_code));
-                        return ServerPage{};
-                }
-
-		auto json = HttpClient::decode(resp);
+	inline std::string publicServersUrl(uint64_t placeId, const std::string &cursor = {}) {
+		return "https://games.roblox.com/v1/games/" + std::to_string(placeId) +
+		       "/servers/Public?sortOrder=Asc&limit=100" + (cursor.empty() ? "" : "&cursor=" + cursor);
+	}
 
+	inline ServerPage parseServerPage(const nlohmann::json &json) {
 		ServerPage page;
 		if (json.contains("nextPageCursor")) {
 			page.nextCursor = json["nextPageCursor"].is_null()
@@ -129,25 +151,79 @@ namespace Roblox {
 		return page;
 	}
 
-	static std::vector<GameInfo> searchGames(const std::string &query) {
-		const std::string sessionId = generateSessionId();
-		auto resp = HttpClient::get(
+	// Streaming counterpart of parseServerPage(): fills `page` as the body is
+	// read, without a DOM in between.
+	inline auto serverPageSax(ServerPage &page) {
+		return HttpClient::makeArraySax(
+			"data", page.data,
+			[](PublicServerInfo &s, std::string_view key, nlohmann::json &v) {
+				if (key == "id")
+					s.jobId = HttpClient::saxString(v);
+				else if (key == "playing")
+					s.currentPlayers = HttpClient::saxInt(v);
+				else if (key == "maxPlayers")
+					s.maximumPlayers = HttpClient::saxInt(v);
+				else if (key == "ping")
+					s.averagePing = HttpClient::saxDouble(v);
+				else if (key == "fps")
+					s.averageFps = HttpClient::saxDouble(v);
+			},
+			[&page](std::string_view key, nlohmann::json &v) {
+				if (key == "nextPageCursor")
+					page.nextCursor = HttpClient::saxString(v);
+				else if (key == "previousPageCursor")
+					page.prevCursor = HttpClient::saxString(v);
+			});
+	}
+
+	inline bool decodeServerPage(std::string_view body, ServerPage &page) {
+		auto sax = serverPageSax(page);
+		return HttpClient::saxParse(body, sax);
+	}
+
+	static ServerPage getPublicServersPage(uint64_t placeId,
+	                                       const std::string &cursor = {}) {
+		ServerPage page;
+		auto sax = serverPageSax(page);
+		auto resp = HttpClient::getSax(publicServersUrl(placeId, cursor), sax);
+		if (resp.status_code < 200 || resp.status_code >= 300) {
+			LOG_ERROR("Failed to fetch servers: HTTP " + std::to_string(resp.status_code));
+			return ServerPage{};
+		}
+		return resp.parsed ? page : ServerPage{};
+	}
+
+	struct GameSearchPage {
+		bool ok = false;
+		std::vector<GameInfo> games;
+		std::string nextPageToken; // empty on the last page
+	};
+
+	// One page of omni-search results. Pages of the same search share
+	// `sessionId`; `pageToken` is the previous page's nextPageToken.
+	static GameSearchPage searchGamesPage(const std::string &query,
+	                                      const std::string &sessionId,
+	                                      const std::string &pageToken = {}) {
+		auto resp = HttpClient::getJsonStreamed(
 			"https://apis.roblox.com/search-api/omni-search",
 			{{"Accept", "application/json"}},
 			cpr::Parameters{
 				{"searchQuery", query},
-				{"pageToken", ""},
+				{"pageToken", pageToken},
 				{"sessionId", sessionId},
 				{"pageType", "all"}
 			});
 
-                std::vector<GameInfo> out;
-                if (resp.status_code < 200 || resp.status_code >= 300) {
-                        LOG_ERROR("Game search failed: HTTP " + std::to_string(resp.status_code));
-                        return out;
-                }
+		GameSearchPage page;
+		if (resp->status_code < 200 || resp->status_code >= 300) {
+			LOG_ERROR("Game search failed: HTTP " + std::to_string(resp->status_code));
+			return page;
+		}
+		page.ok = true;
 
-		auto j = HttpClient::decode(resp);
+		const auto &j = resp->body;
+		if (j.contains("nextPageToken") && j["nextPageToken"].is_string())
+			page.nextPageToken = j["nextPageToken"].get<std::string>();
 
 		if (j.contains("searchResults") && j["searchResults"].is_array()) {
 			for (auto &group: j["searchResults"]) {
@@ -167,11 +243,15 @@ namespace Roblox {
 					info.downVotes = g.value("totalDownVotes", 0);
 					info.creatorName = g.value("creatorName", "");
 					info.creatorVerified = g.value("creatorHasVerifiedBadge", false);
-					out.push_back(std::move(info));
+					page.games.push_back(std::move(info));
 				}
 			}
 		}
 
-		return out;
+		return page;
+	}
+
+	static std::vector<GameInfo> searchGames(const std::string &query) {
+		return searchGamesPage(query, generateSessionId()).games;
 	}
 }
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "http.hpp"
+#include "core/logging.hpp"
+#include "../../components/data.h"
+
+namespace Roblox {
+	// In-process stand-in for the Roblox web APIs the app talks to: presence,
+	// friends, servers, games, inventory, thumbnails, moderation and auth
+	// tickets. Every answer is derived from the ids in the request, so any
+	// number of fake accounts (".ROBLOSECURITY=anything") gets stable data.
+	// Writes and ticket requests enforce the usual x-csrf-token handshake.
+	class MockTransport : public HttpClient::LocalTransport {
+		public:
+			static constexpr const char *kCsrfToken = "mock-csrf-token";
+
+			MockTransport(std::chrono::milliseconds latency, std::chrono::milliseconds jitter) :
+				latency_(latency), jitter_(jitter) {}
+
+			const char *name() const override { return "mock"; }
+
+		protected:
+			std::chrono::milliseconds delay() override {
+				if (jitter_.count() <= 0)
+					return latency_;
+				std::lock_guard<std::mutex> lock(rngMtx_);
+				std::uniform_int_distribution<long long> dist(0, jitter_.count());
+				return latency_ + std::chrono::milliseconds(dist(rng_));
+			}
+
+			HttpClient::Response respond(const HttpClient::Request &req) override {
+				using nlohmann::json;
+				Url u = split(req);
+				auto seg = segments(u.path);
+				auto at = [&](size_t i) { return i < seg.size() ? seg[i] : std::string(); };
+				bool post = req.method == "POST";
+
+				if (post && needsCsrf(u.host)) {
+					auto it = req.headers.find("X-CSRF-TOKEN");
+					if (it == req.headers.end() || it->second != kCsrfToken)
+						return {403, R"({"errors":[{"code":0,"message":"Token Validation Failed"}]})",
+						        {{"x-csrf-token", kCsrfToken}}};
+				}
+
+				if (u.host.starts_with("auth.") && u.path == "/v1/authentication-ticket")
+					return {200, "{}", {{"rbx-authentication-ticket", "mock-ticket-" + std::to_string(seed(cookieOf(req)))}}};
+
+				if (u.host.starts_with("usermoderation."))
+					return ok(json::object());
+
+				if (u.host.starts_with("voice."))
+					return ok({{"isVoiceEnabled", false}, {"isUserOptIn", false}, {"isUserEligible", true},
+					           {"isBanned", false}, {"bannedUntil", nullptr}});
+
+				if (u.host.starts_with("users.")) {
+					if (u.path == "/v1/users/authenticated")
+						return ok(user(accountId(cookieOf(req))));
+					if (u.path == "/v1/usernames/users" && post) {
+						json out = json::array();
+						for (const auto &name: parse(req.body).value("usernames", json::array())) {
+							json entry = user(seed(name.get<std::string>()) % 5000000000ULL + 1);
+							entry["requestedUsername"] = name;
+							out.push_back(entry);
+						}
+						return ok({{"data", out}});
+					}
+					if (at(0) == "v1" && at(1) == "users" && seg.size() == 3)
+						return ok(user(toId(at(2))));
+				}
+
+				if (u.host.starts_with("presence.") && u.path == "/v1/presence/users") {
+					json list = json::array();
+					for (const auto &id: parse(req.body).value("userIds", json::array()))
+						list.push_back(presence(id.get<uint64_t>()));
+					return ok({{"userPresences", list}});
+				}
+
+				if (u.host.starts_with("friends.")) {
+					if (post)
+						return ok({{"success", true}});
+					if (at(1) == "my")
+						return ok({{"data", json::array()}, {"nextPageCursor", nullptr}, {"previousPageCursor", nullptr}});
+					uint64_t id = toId(at(2));
+					if (at(4) == "count")
+						return ok({{"count", seed(u.path) % 500}});
+					if (at(3) == "friends") {
+						json list = json::array();
+						for (uint64_t i = 0, n = seed(id) % 150; i < n; ++i)
+							list.push_back(user(seed(std::to_string(id) + '/' + std::to_string(i)) % 5000000000ULL + 1));
+						return ok({{"data", list}});
+					}
+				}
+
+				if (u.host.starts_with("www.") && post && u.path.ends_with("/block"))
+					return ok(json::object());
+
+				if (u.host.starts_with("games.")) {
+					if (at(3) == "servers")
+						return servers(toId(at(2)), queryValue(u.query, "cursor"));
+					if (u.path == "/v1/games") {
+						json list = json::array();
+						for (uint64_t id: idList(queryValue(u.query, "universeIds")))
+							list.push_back(game(id));
+						return ok({{"data", list}});
+					}
+				}
+
+				if (u.host.starts_with("apis.") && u.path.starts_with("/search-api/")) {
+					json contents = json::array();
+					std::string q = queryValue(u.query, "searchQuery");
+					for (int i = 0; i < 20; ++i) {
+						uint64_t universe = seed(q + std::to_string(i)) % 9000000000ULL + 1;
+						json g = game(universe);
+						contents.push_back({{"name", g["name"]}, {"universeId", universe}, {"rootPlaceId", g["rootPlaceId"]},
+						                    {"playerCount", g["playing"]}, {"totalUpVotes", seed(g["name"].get<std::string>()) % 100000},
+						                    {"totalDownVotes", universe % 5000}, {"creatorName", "MockStudio"},
+						                    {"creatorHasVerifiedBadge", false}});
+					}
+					return ok({{"searchResults", json::array({{{"contentGroupType", "Game"}, {"contents", contents}}})}});
+				}
+
+				if (u.host.starts_with("inventory.")) {
+					if (at(3) == "categories")
+						return ok({{"categories", json::array({
+							{{"displayName", "Accessories"}, {"items", json::array({
+								{{"id", 8}, {"displayName", "Hats"}},
+								{{"id", 41}, {"displayName", "Hair"}}})}},
+							{{"displayName", "Clothing"}, {"items", json::array({
+								{{"id", 11}, {"displayName", "Shirts"}},
+								{{"id", 12}, {"displayName", "Pants"}}})}}})}});
+					if (at(3) == "inventory")
+						return inventory(toId(at(2)), toId(at(4)), queryValue(u.query, "cursor"));
+				}
+
+				if (u.host.starts_with("thumbnails.")) {
+					std::string ids = queryValue(u.query, "userIds");
+					if (ids.empty())
+						ids = queryValue(u.query, "assetIds");
+					if (ids.empty())
+						ids = queryValue(u.query, "universeIds");
+					json list = json::array();
+					for (uint64_t id: idList(ids))
+						list.push_back({{"targetId", id}, {"state", "Completed"},
+						                {"imageUrl", "https://tr.rbxcdn.com/mock/" + std::to_string(id) + ".png"}});
+					return ok({{"data", list}});
+				}
+
+				return {404, R"({"errors":[{"code":0,"message":"NotFound"}]})", {}};
+			}
+
+		private:
+			struct Url {
+				std::string host;
+				std::string path;
+				std::string query;
+			};
+
+			static Url split(const HttpClient::Request &req) {
+				const std::string &url = req.url;
+				size_t schemeEnd = url.find("://");
+				size_t hostStart = schemeEnd == std::string::npos ? 0 : schemeEnd + 3;
+				size_t pathStart = url.find('/', hostStart);
+				size_t queryStart = url.find('?', hostStart);
+				Url u;
+				u.host = url.substr(hostStart, std::min(pathStart, queryStart) - hostStart);
+				if (pathStart != std::string::npos)
+					u.path = url.substr(pathStart, queryStart == std::string::npos ? std::string::npos : queryStart - pathStart);
+				if (queryStart != std::string::npos)
+					u.query = url.substr(queryStart + 1);
+				std::string extra = HttpClient::queryOf(req);
+				if (!extra.empty())
+					u.query += (u.query.empty() ? "" : "&") + extra;
+				return u;
+			}
+
+			static std::vector<std::string> segments(const std::string &path) {
+				std::vector<std::string> out;
+				size_t pos = 0;
+				while (pos < path.size()) {
+					size_t next = path.find('/', pos);
+					if (next == std::string::npos)
+						next = path.size();
+					if (next > pos)
+						out.push_back(path.substr(pos, next - pos));
+					pos = next + 1;
+				}
+				return out;
+			}
+
+			static std::string queryValue(const std::string &query, const std::string &key) {
+				size_t pos = 0;
+				while (pos <= query.size()) {
+					size_t end = query.find('&', pos);
+					if (end == std::string::npos)
+						end = query.size();
+					std::string pair = query.substr(pos, end - pos);
+					if (pair.size() > key.size() && pair.compare(0, key.size(), key) == 0 && pair[key.size()] == '=')
+						return pair.substr(key.size() + 1);
+					pos = end + 1;
+				}
+				return {};
+			}
+
+			static std::vector<uint64_t> idList(const std::string &csv) {
+				std::vector<uint64_t> out;
+				size_t pos = 0;
+				while (pos < csv.size()) {
+					size_t end = csv.find_first_of(",%", pos);
+					if (end == std::string::npos)
+						end = csv.size();
+					if (uint64_t id = toId(csv.substr(pos, end - pos)))
+						out.push_back(id);
+					// Skip a URL-encoded comma ("%2C") as well as a plain one.
+					pos = end + (csv.compare(end, 3, "%2C") == 0 ? 3 : 1);
+				}
+				return out;
+			}
+
+			static uint64_t toId(const std::string &s) {
+				try {
+					return s.empty() ? 0 : std::stoull(s);
+				} catch (...) {
+					return 0;
+				}
+			}
+
+			static nlohmann::json parse(const std::string &body) {
+				auto j = nlohmann::json::parse(body, nullptr, false);
+				return j.is_object() ? j : nlohmann::json::object();
+			}
+
+			static std::string cookieOf(const HttpClient::Request &req) {
+				auto it = req.headers.find("Cookie");
+				return it == req.headers.end() ? std::string() : it->second;
+			}
+
+			static bool needsCsrf(const std::string &host) {
+				return host.starts_with("auth.") || host.starts_with("friends.") || host.starts_with("www.");
+			}
+
+			static uint64_t seed(const std::string &s) { return HttpClient::fnv1a(s); }
+			static uint64_t seed(uint64_t id) { return HttpClient::fnv1a(std::to_string(id)); }
+
+			static uint64_t accountId(const std::string &cookie) { return seed(cookie) % 5000000000ULL + 1; }
+
+			static HttpClient::Response ok(const nlohmann::json &body) {
+				return {200, body.dump(), {{"content-type", "application/json; charset=utf-8"}}};
+			}
+
+			static nlohmann::json user(uint64_t id) {
+				std::string name = "MockUser" + std::to_string(id);
+				return {{"id", id}, {"name", name}, {"displayName", name}, {"description", ""},
+				        {"created", "2016-05-01T12:00:00.000Z"}, {"isBanned", false}, {"hasVerifiedBadge", false}};
+			}
+
+			static nlohmann::json presence(uint64_t userId) {
+				int type = static_cast<int>(seed(userId) % 4);
+				nlohmann::json p = {{"userPresenceType", type}, {"userId", userId}, {"lastLocation", ""},
+				                    {"placeId", nullptr}, {"rootPlaceId", nullptr}, {"gameId", nullptr},
+				                    {"universeId", nullptr}, {"lastOnline", "2024-01-01T00:00:00.000Z"}};
+				if (type == 2) {
+					uint64_t place = seed(userId) % 1000 + 1000;
+					p["placeId"] = place;
+					p["rootPlaceId"] = place;
+					p["universeId"] = place * 7;
+					p["gameId"] = jobId(place, seed(userId) % 50);
+					p["lastLocation"] = "Mock Place " + std::to_string(place);
+				}
+				return p;
+			}
+
+			static std::string jobId(uint64_t placeId, uint64_t index) {
+				char buf[40];
+				uint64_t h = seed(std::to_string(placeId) + '#' + std::to_string(index));
+				std::snprintf(buf, sizeof(buf), "%08llx-%04llx-4%03llx-8%03llx-%012llx",
+				              static_cast<unsigned long long>(h >> 32), static_cast<unsigned long long>(h >> 16 & 0xffff),
+				              static_cast<unsigned long long>(h >> 4 & 0xfff), static_cast<unsigned long long>(h & 0xfff),
+				              static_cast<unsigned long long>(h * 31 & 0xffffffffffffULL));
+				return buf;
+			}
+
+			static nlohmann::json game(uint64_t universeId) {
+				uint64_t h = seed(universeId);
+				return {{"id", universeId}, {"rootPlaceId", universeId / 7 ? universeId / 7 : universeId},
+				        {"name", "Mock Experience " + std::to_string(universeId)}, {"description", "Synthetic game"},
+				        {"genre", "All"}, {"genre_l1", ""}, {"genre_l2", ""}, {"price", nullptr},
+				        {"playing", h % 50000}, {"visits", h % 100000000}, {"maxPlayers", 30},
+				        {"favoritedCount", h % 1000000}, {"created", "2019-03-01T00:00:00.000Z"},
+				        {"updated", "2024-06-01T00:00:00.000Z"},
+				        {"creator", {{"id", h % 100000}, {"name", "MockStudio"}, {"type", "Group"},
+				                     {"hasVerifiedBadge", false}}}};
+			}
+
+			// Five pages of 100 servers per place; the cursor is the page number.
+			static HttpClient::Response servers(uint64_t placeId, const std::string &cursor) {
+				constexpr uint64_t kPages = 5;
+				uint64_t page = toId(cursor);
+				nlohmann::json list = nlohmann::json::array();
+				for (uint64_t i = 0; i < 100; ++i) {
+					uint64_t index = page * 100 + i;
+					uint64_t h = seed(std::to_string(placeId) + '#' + std::to_string(index));
+					list.push_back({{"id", jobId(placeId, index)}, {"maxPlayers", 30}, {"playing", h % 31},
+					                {"fps", 40.0 + static_cast<double>(h % 200) / 10.0}, {"ping", static_cast<int>(h % 250)}});
+				}
+				nlohmann::json next = page + 1 < kPages ? nlohmann::json(std::to_string(page + 1)) : nlohmann::json();
+				nlohmann::json prev = page > 0 ? nlohmann::json(std::to_string(page - 1)) : nlohmann::json();
+				return ok({{"data", list}, {"nextPageCursor", next}, {"previousPageCursor", prev}});
+			}
+
+			static HttpClient::Response inventory(uint64_t userId, uint64_t assetType, const std::string &cursor) {
+				constexpr uint64_t kPages = 3;
+				uint64_t page = toId(cursor);
+				nlohmann::json list = nlohmann::json::array();
+				for (uint64_t i = 0; i < 100; ++i) {
+					uint64_t asset = seed(std::to_string(userId) + '/' + std::to_string(assetType) + '/' +
+					                      std::to_string(page * 100 + i)) % 2000000000ULL + 1;
+					list.push_back({{"assetId", asset}, {"assetName", "Mock Item " + std::to_string(asset)}});
+				}
+				nlohmann::json next = page + 1 < kPages ? nlohmann::json(std::to_string(page + 1)) : nlohmann::json();
+				return ok({{"data", list}, {"nextPageCursor", next}});
+			}
+
+			std::chrono::milliseconds latency_;
+			std::chrono::milliseconds jitter_;
+			std::mutex rngMtx_;
+			std::mt19937_64 rng_{std::random_device{}()};
+	};
+
+	// Picks the HTTP transport from the environment, for offline runs:
+	//   ALTMAN_TRANSPORT=live|record|replay|mock (default live)
+	//   ALTMAN_FIXTURES=<dir>  fixtures for record/replay (default storage/fixtures)
+	//   ALTMAN_MOCK_LATENCY_MS / ALTMAN_MOCK_JITTER_MS  simulated mock latency
+	inline void configureTransportFromEnvironment() {
+		auto env = [](const char *name) {
+			const char *v = std::getenv(name);
+			return std::string(v ? v : "");
+		};
+		auto envMs = [&](const char *name, long long fallback) {
+			try {
+				std::string v = env(name);
+				return std::chrono::milliseconds(v.empty() ? fallback : std::stoll(v));
+			} catch (...) {
+				return std::chrono::milliseconds(fallback);
+			}
+		};
+
+		std::string mode = env("ALTMAN_TRANSPORT");
+		if (mode.empty() || mode == "live")
+			return;
+
+		std::filesystem::path fixtures = env("ALTMAN_FIXTURES");
+		if (fixtures.empty())
+			fixtures = Data::StorageFilePath("fixtures");
+
+		if (mode == "record")
+			HttpClient::setTransport(std::make_shared<HttpClient::RecordingTransport>(fixtures));
+		else if (mode == "replay")
+			HttpClient::setTransport(std::make_shared<HttpClient::ReplayTransport>(fixtures));
+		else if (mode == "mock")
+			HttpClient::setTransport(std::make_shared<MockTransport>(
+				envMs("ALTMAN_MOCK_LATENCY_MS", 80), envMs("ALTMAN_MOCK_JITTER_MS", 40)));
+		else
+			LOG_ERROR("Unknown ALTMAN_TRANSPORT '" + mode + "', staying live");
+	}
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "http.hpp"
+#include "core/logging.hpp"
+#include "system/threading.h"
+#include "games.h"
+
+namespace Roblox {
+	// Public servers of one place, one entry per jobId. A server seen again on
+	// a later page (listings shift while they are paged) is updated in place.
+	class ServerStore {
+		public:
+			// Returns true if the server was not in the store yet.
+			bool upsert(PublicServerInfo server) {
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				version_.fetch_add(1, std::memory_order_release);
+				auto it = byJobId_.find(server.jobId);
+				if (it != byJobId_.end()) {
+					servers_[it->second] = std::move(server);
+					return false;
+				}
+				byJobId_.emplace(server.jobId, servers_.size());
+				servers_.push_back(std::move(server));
+				return true;
+			}
+
+			std::optional<PublicServerInfo> find(const std::string &jobId) const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				auto it = byJobId_.find(jobId);
+				if (it == byJobId_.end())
+					return std::nullopt;
+				return servers_[it->second];
+			}
+
+			std::vector<PublicServerInfo> snapshot() const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				return servers_;
+			}
+
+			size_t size() const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				return servers_.size();
+			}
+
+			// Bumped on every change, so readers only re-copy when it moved.
+			uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+		private:
+			mutable std::shared_mutex mtx_;
+			std::vector<PublicServerInfo> servers_;
+			std::unordered_map<std::string, size_t> byJobId_;
+			std::atomic<uint64_t> version_{0};
+	};
+
+	// Stop crawling as soon as a server matching this turns up.
+	struct CrawlTarget {
+		std::string jobId;
+		int minFreeSlots = 0; // 0 = no slot requirement
+
+		bool empty() const { return jobId.empty() && minFreeSlots <= 0; }
+
+		bool matches(const PublicServerInfo &s) const {
+			if (empty())
+				return false;
+			if (!jobId.empty() && s.jobId != jobId)
+				return false;
+			return minFreeSlots <= 0 || s.maximumPlayers - s.currentPlayers >= minFreeSlots;
+		}
+	};
+
+	// Walks every page of a place's public server list. One thread downloads
+	// pages back to back, reading just the next cursor out of the raw body so
+	// the following request starts right away; a second thread parses the
+	// pages it hands over and fills the store.
+	class ServerCrawler {
+		public:
+			static constexpr size_t kMaxPages = 1000;
+			static constexpr size_t kMaxQueuedPages = 4;
+
+			static std::shared_ptr<ServerCrawler> start(uint64_t placeId, CrawlTarget target = {}) {
+				auto crawler = std::shared_ptr<ServerCrawler>(new ServerCrawler(placeId, std::move(target)));
+				Threading::longRunning([crawler] { crawler->download(); });
+				Threading::longRunning([crawler] { crawler->parse(); });
+				return crawler;
+			}
+
+			void stop() {
+				{
+					// Taken so a thread between its predicate check and wait() can't miss this.
+					std::lock_guard<std::mutex> lock(mtx_);
+					cancel_.cancel();
+				}
+				cv_.notify_all();
+			}
+
+			bool running() const { return !finished_.load(std::memory_order_acquire); }
+			uint64_t placeId() const { return placeId_; }
+			size_t pages() const { return pages_.load(std::memory_order_relaxed); }
+			const ServerStore &store() const { return store_; }
+
+			std::optional<PublicServerInfo> found() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return found_;
+			}
+
+		private:
+			ServerCrawler(uint64_t placeId, CrawlTarget target) :
+				placeId_(placeId), target_(std::move(target)), cancel_(HttpClient::CancelToken::create()) {}
+
+			// Value of "nextPageCursor" without parsing the page; empty when it
+			// is null or missing.
+			static std::string peekNextCursor(std::string_view body) {
+				constexpr std::string_view key = "\"nextPageCursor\"";
+				size_t pos = body.find(key);
+				if (pos == std::string_view::npos)
+					return {};
+				pos = body.find_first_not_of(" \t\r\n:", pos + key.size());
+				if (pos == std::string_view::npos || body[pos] != '"')
+					return {};
+				std::string out;
+				for (++pos; pos < body.size() && body[pos] != '"'; ++pos) {
+					if (body[pos] == '\\' && pos + 1 < body.size())
+						++pos;
+					out += body[pos];
+				}
+				return out;
+			}
+
+			void download() {
+				HttpClient::RequestScope scope(cancel_);
+				std::string cursor;
+				for (size_t page = 0; page < kMaxPages && !cancel_.cancelled(); ++page) {
+					auto resp = HttpClient::get(publicServersUrl(placeId_, cursor));
+					if (resp.status_code < 200 || resp.status_code >= 300) {
+						if (!cancel_.cancelled())
+							LOG_ERROR("Server crawl stopped: HTTP " + std::to_string(resp.status_code));
+						break;
+					}
+					cursor = peekNextCursor(resp.text);
+					{
+						std::unique_lock<std::mutex> lock(mtx_);
+						cv_.wait(lock, [&] { return queue_.size() < kMaxQueuedPages || cancel_.cancelled(); });
+						queue_.push_back(std::move(resp.text));
+					}
+					cv_.notify_all();
+					if (cursor.empty())
+						break;
+				}
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					downloadDone_ = true;
+				}
+				cv_.notify_all();
+			}
+
+			void parse() {
+				while (true) {
+					std::string body;
+					{
+						std::unique_lock<std::mutex> lock(mtx_);
+						cv_.wait(lock, [&] { return !queue_.empty() || downloadDone_ || cancel_.cancelled(); });
+						if (queue_.empty() || cancel_.cancelled())
+							break;
+						body = std::move(queue_.front());
+						queue_.pop_front();
+					}
+					cv_.notify_all();
+
+					ServerPage page;
+					if (!decodeServerPage(body, page)) {
+						LOG_ERROR("Server crawl: unparsable page");
+						continue;
+					}
+					for (auto &server: page.data) {
+						if (!cancel_.cancelled() && target_.matches(server)) {
+							{
+								std::lock_guard<std::mutex> lock(mtx_);
+								found_ = server;
+							}
+							stop();
+						}
+						store_.upsert(std::move(server));
+					}
+					pages_.fetch_add(1, std::memory_order_relaxed);
+				}
+				finished_.store(true, std::memory_order_release);
+				LOG_INFO("Server crawl finished: " + std::to_string(store_.size()) + " servers in " +
+				         std::to_string(pages()) + " pages");
+			}
+
+			const uint64_t placeId_;
+			const CrawlTarget target_;
+			HttpClient::CancelToken cancel_;
+			ServerStore store_;
+
+			mutable std::mutex mtx_;
+			std::condition_variable cv_;
+			std::deque<std::string> queue_;
+			bool downloadDone_ = false;
+			std::optional<PublicServerInfo> found_;
+
+			std::atomic<size_t> pages_{0};
+			std::atomic<bool> finished_{false};
+	};
+}
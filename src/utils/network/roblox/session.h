@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <future>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -120,6 +122,25 @@ namespace Roblox {
 		std::string jobId;
 	};
 
+	static std::unordered_map<uint64_t, PresenceData> parsePresences(const nlohmann::json &j) {
+		std::unordered_map<uint64_t, PresenceData> out;
+		if (j.contains("userPresences") && j["userPresences"].is_array()) {
+			for (auto &up: j["userPresences"]) {
+				PresenceData d;
+				d.presence = presenceTypeToString(up.value("userPresenceType", 0));
+				d.lastLocation = up.value("lastLocation", "");
+				if (up.contains("placeId") && up["placeId"].is_number_unsigned())
+					d.placeId = up["placeId"].get<uint64_t>();
+				// API uses field name 'gameId' for jobId; we store it as jobId internally
+				if (up.contains("gameId") && !up["gameId"].is_null())
+					d.jobId = up["gameId"].get<std::string>();
+				if (up.contains("userId"))
+					out[up["userId"].get<uint64_t>()] = std::move(d);
+			}
+		}
+		return out;
+	}
+
 	static std::unordered_map<uint64_t, PresenceData>
         getPresences(const std::vector<uint64_t> &userIds,
                      const std::string &cookie) {
@@ -138,22 +159,40 @@ namespace Roblox {
                         return {};
                 }
 
-		nlohmann::json j = HttpClient::decode(resp);
-		std::unordered_map<uint64_t, PresenceData> out;
+		return parsePresences(HttpClient::decode(resp));
+	}
 
-		if (j.contains("userPresences") && j["userPresences"].is_array()) {
-			for (auto &up: j["userPresences"]) {
-				PresenceData d;
-				d.presence = presenceTypeToString(up.value("userPresenceType", 0));
-				d.lastLocation = up.value("lastLocation", "");
-				if (up.contains("placeId") && up["placeId"].is_number_unsigned())
-					d.placeId = up["placeId"].get<uint64_t>();
-				// API uses field name 'gameId' for jobId; we store it as jobId internally
-				if (up.contains("gameId") && !up["gameId"].is_null())
-					d.jobId = up["gameId"].get<std::string>();
-				if (up.contains("userId"))
-					out[up["userId"].get<uint64_t>()] = std::move(d);
+	// presence.roblox.com/v1/presence/users accepts at most this many userIds.
+	static constexpr size_t kPresenceBatchSize = 100;
+
+	// Presence of any number of users, one request per kPresenceBatchSize ids
+	// with all of them in flight at once. A failed batch just leaves its users
+	// out of the result.
+	static std::unordered_map<uint64_t, PresenceData>
+	getPresencesBatched(const std::vector<uint64_t> &userIds, const std::string &cookie) {
+		if (userIds.empty() || !canUseCookie(cookie))
+			return {};
+
+		std::vector<std::future<HttpClient::Response> > batches;
+		batches.reserve((userIds.size() + kPresenceBatchSize - 1) / kPresenceBatchSize);
+		for (size_t i = 0; i < userIds.size(); i += kPresenceBatchSize) {
+			size_t end = (std::min)(userIds.size(), i + kPresenceBatchSize);
+			nlohmann::json payload = {{"userIds", std::vector<uint64_t>(userIds.begin() + i, userIds.begin() + end)}};
+			batches.push_back(HttpClient::postAsync(
+				"https://presence.roblox.com/v1/presence/users",
+				{{"Cookie", ".ROBLOSECURITY=" + cookie}},
+				payload.dump()));
+		}
+
+		std::unordered_map<uint64_t, PresenceData> out;
+		out.reserve(userIds.size());
+		for (auto &batch: batches) {
+			auto resp = batch.get();
+			if (resp.status_code < 200 || resp.status_code >= 300) {
+				LOG_ERROR("Batch presence failed: HTTP " + std::to_string(resp.status_code));
+				continue;
 			}
+			out.merge(parsePresences(HttpClient::decode(resp)));
 		}
 		return out;
 	}
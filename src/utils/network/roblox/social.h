@@ -1,52 +1,110 @@
 #pragma once
 
-#include <condition_variable>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <nlohmann/json.hpp>
 
 #include "http.hpp"
 #include "core/logging.hpp"
 #include "auth.h"
-#include "threading.h"
+#include "csrf.h"
+#include "common.h"
 
 #include "../../components/components.h"
 
 namespace Roblox
 {
-	static std::vector<FriendInfo> getFriends(const std::string &userId, const std::string &cookie)
+	struct FriendsPage
 	{
-		if (!canUseCookie(cookie))
-			return {};
+		std::vector<FriendInfo> data;
+		std::string nextCursor;
+	};
 
-		LOG_INFO("Fetching friends list");
+	// Decodes a friends listing straight into FriendInfo; see HttpClient::ArraySax.
+	inline auto friendsPageSax(FriendsPage &page)
+	{
+		return HttpClient::makeArraySax(
+			"data", page.data,
+			[](FriendInfo &f, std::string_view key, nlohmann::json &v)
+			{
+				if (key == "id")
+					f.id = HttpClient::saxUint(v);
+				else if (key == "name")
+					f.username = HttpClient::saxString(v);
+				else if (key == "displayName")
+					f.displayName = HttpClient::saxString(v);
+			},
+			[&page](std::string_view key, nlohmann::json &v)
+			{
+				if (key == "nextPageCursor")
+					page.nextCursor = HttpClient::saxString(v);
+			});
+	}
 
-		HttpClient::Response resp = HttpClient::get(
-			"https://friends.roblox.com/v1/users/" + userId + "/friends",
-			{{"Cookie", ".ROBLOSECURITY=" + cookie}});
+	// Upper bound on pages followed, in case a cursor never runs out.
+	static constexpr size_t kMaxFriendPages = 100;
 
-		if (resp.status_code < 200 || resp.status_code >= 300)
-		{
-			LOG_ERROR("Failed to fetch friends: HTTP " + std::to_string(resp.status_code));
-			return {};
-		}
+	// Every friend of `userId`, following nextPageCursor until the list ends.
+	// A user listed again on a later page is kept once, at its first slot.
+	// nullopt unless every page arrived: a partial list must never be taken
+	// for the whole one.
+	static std::optional<std::vector<FriendInfo>> getFriends(const std::string &userId, const std::string &cookie)
+	{
+		if (!canUseCookie(cookie))
+			return std::nullopt;
+
+		LOG_INFO("Fetching friends list");
 
-		nlohmann::json j = HttpClient::decode(resp);
 		std::vector<FriendInfo> friends;
-		if (j.contains("data") && j["data"].is_array())
+		std::unordered_map<uint64_t, size_t> slotById;
+		std::string cursor;
+		for (size_t page = 0; page < kMaxFriendPages; ++page)
 		{
-			for (const auto &item : j["data"])
+			cpr::Parameters params;
+			if (!cursor.empty())
+				params.Add({"cursor", cursor});
+			FriendsPage decoded;
+			auto sax = friendsPageSax(decoded);
+			auto resp = HttpClient::getSax(
+				"https://friends.roblox.com/v1/users/" + userId + "/friends",
+				sax,
+				{{"Cookie", ".ROBLOSECURITY=" + cookie}},
+				std::move(params));
+
+			if (resp.status_code < 200 || resp.status_code >= 300 || !resp.parsed)
 			{
-				FriendInfo f;
-				f.id = item.value("id", 0ULL);
-				f.displayName = item.value("displayName", "");
-				f.username = item.value("name", "");
-				friends.push_back(f);
+				LOG_ERROR("Failed to fetch friends (page " + std::to_string(page + 1) + "): HTTP " +
+				          std::to_string(resp.status_code));
+				return std::nullopt;
 			}
+
+			friends.reserve(friends.size() + decoded.data.size());
+			for (auto &f : decoded.data)
+			{
+				auto [it, inserted] = slotById.try_emplace(f.id, friends.size());
+				if (inserted)
+					friends.push_back(std::move(f));
+				else
+					friends[it->second] = std::move(f);
+			}
+
+			cursor = std::move(decoded.nextCursor);
+			if (cursor.empty())
+				return friends;
 		}
-		return friends;
+		LOG_ERROR("Friends list still continues after " + std::to_string(kMaxFriendPages) + " pages");
+		return std::nullopt;
 	}
 
 	static FriendInfo getUserInfo(const std::string &userId)
@@ -73,6 +131,17 @@ namespace Roblox
 		return f;
 	}
 
+	// Parts of a FriendDetail; each is set in `loaded` once its request has
+	// finished, and also in `failed` if it did not succeed.
+	enum ProfilePart : unsigned
+	{
+		ProfileUser = 1u << 0,
+		ProfileFollowers = 1u << 1,
+		ProfileFollowing = 1u << 2,
+		ProfileFriends = 1u << 3,
+		ProfileAll = ProfileUser | ProfileFollowers | ProfileFollowing | ProfileFriends,
+	};
+
 	struct FriendDetail
 	{
 		uint64_t id = 0;
@@ -85,92 +154,201 @@ namespace Roblox
 		int following = 0;
 		int placeVisits = 0;
 		std::string presence;
+		unsigned loaded = 0; // ProfilePart bits
+		unsigned failed = 0; // ProfilePart bits, a subset of `loaded`
 	};
 
-	static FriendDetail getUserDetails(const std::string &userId,
-									   const std::string &cookie)
+	// Profile, follower, following and friend counts of a user, fetched
+	// together on the shared I/O loop and kept for a short while so clicking
+	// back and forth between friends doesn't refetch them. Only profiles whose
+	// every part succeeded are kept; anything else is refetched next time.
+	class ProfileService
 	{
-		if (!canUseCookie(cookie))
-			return FriendDetail{};
+		public:
+			static constexpr auto kTtl = std::chrono::minutes(2);
+			static constexpr size_t kMaxEntries = 512;
 
-		FriendDetail d;
-		mutex m;
-		condition_variable cv;
-		int remaining = 4;
+			using Listener = std::function<void(const FriendDetail &)>;
 
-		auto signalDone = [&]
-		{
-			lock_guard<mutex> lk(m);
-			if (--remaining == 0)
-				cv.notify_one();
-		};
+			// Calls `onUpdate` with everything known so far each time a part
+			// arrives, the last time with loaded == ProfileAll. Runs on the I/O
+			// thread, or inline when the profile is cached.
+			void fetch(uint64_t userId, Listener onUpdate)
+			{
+				FriendDetail cachedDetail;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					if (entries_.size() >= kMaxEntries && !entries_.count(userId))
+						makeRoom();
+					Entry &e = entries_[userId];
+					if (e.inFlight)
+					{
+						// Joins the fetch already running; the next part brings it up to date.
+						e.listeners.push_back(std::move(onUpdate));
+						return;
+					}
+					if (complete(e))
+					{
+						cachedDetail = e.detail;
+					}
+					else
+					{
+						e.detail = FriendDetail{};
+						e.detail.id = userId;
+						e.inFlight = true;
+						e.listeners.clear();
+						e.listeners.push_back(onUpdate);
+					}
+				}
+				if (cachedDetail.loaded == ProfileAll)
+				{
+					onUpdate(cachedDetail);
+					return;
+				}
 
-		Threading::newThread([&, userId]
-							 {
-			auto resp = HttpClient::get(
-				"https://users.roblox.com/v1/users/" + userId,
-				{{"Accept", "application/json"}}
-			);
-                        if (resp.status_code >= 200 && resp.status_code < 300) {
-				nlohmann::json j = HttpClient::decode(resp);
-				d.id = j.value("id", 0ULL);
-				d.username = j.value("name", "");
-				d.displayName = j.value("displayName", "");
-				d.description = j.value("description", "");
-				d.createdIso = j.value("created", "");
+				std::string id = std::to_string(userId);
+				HttpClient::getAsync("https://users.roblox.com/v1/users/" + id, {{"Accept", "application/json"}}, {},
+					[this, userId](HttpClient::Response resp)
+					{
+						nlohmann::json j;
+						if (resp.status_code >= 200 && resp.status_code < 300)
+							j = HttpClient::decode(resp);
+						else
+							LOG_ERROR("Failed to fetch user profile: HTTP " + std::to_string(resp.status_code));
+						finishPart(userId, ProfileUser, j.is_object(), [&](FriendDetail &d)
+						{
+							if (!j.is_object())
+								return;
+							d.username = j.value("name", "");
+							d.displayName = j.value("displayName", "");
+							d.description = j.value("description", "");
+							d.createdIso = j.value("created", "");
+						});
+					});
+				fetchCount("https://friends.roblox.com/v1/users/" + id + "/followers/count", userId, ProfileFollowers,
+				           &FriendDetail::followers);
+				fetchCount("https://friends.roblox.com/v1/users/" + id + "/followings/count", userId, ProfileFollowing,
+				           &FriendDetail::following);
+				fetchCount("https://friends.roblox.com/v1/users/" + id + "/friends/count", userId, ProfileFriends,
+				           &FriendDetail::friends);
 			}
-			signalDone(); });
-
-		Threading::newThread([&, userId]
-							 {
-			auto resp = HttpClient::get(
-				"https://friends.roblox.com/v1/users/" + userId + "/followers/count",
-				{}
-			);
-                        if (resp.status_code >= 200 && resp.status_code < 300) {
-				try {
-					d.followers = nlohmann::json::parse(resp.text).value("count", 0);
-				} catch (const std::exception &e) {
-					LOG_ERROR(std::string("Failed to parse followers count: ") + e.what());
-				}
+
+			std::optional<FriendDetail> cached(uint64_t userId) const
+			{
+				std::lock_guard<std::mutex> lock(mtx_);
+				auto it = entries_.find(userId);
+				if (it == entries_.end() || !complete(it->second))
+					return std::nullopt;
+				return it->second.detail;
+			}
+
+		private:
+			struct Entry
+			{
+				FriendDetail detail;
+				std::chrono::steady_clock::time_point fetchedAt{}; // set only when every part succeeded
+				bool inFlight = false;
+				std::vector<Listener> listeners;
+			};
+
+			static bool complete(const Entry &e)
+			{
+				return !e.inFlight && e.detail.loaded == ProfileAll && e.detail.failed == 0 &&
+				       std::chrono::steady_clock::now() - e.fetchedAt < kTtl;
 			}
-			signalDone(); });
-
-		Threading::newThread([&, userId]
-							 {
-			auto resp = HttpClient::get(
-				"https://friends.roblox.com/v1/users/" + userId + "/followings/count",
-				{}
-			);
-                        if (resp.status_code >= 200 && resp.status_code < 300) {
-				try {
-					d.following = nlohmann::json::parse(resp.text).value("count", 0);
-				} catch (const std::exception &e) {
-					LOG_ERROR(std::string("Failed to parse following count: ") + e.what());
+
+			void fetchCount(const std::string &url, uint64_t userId, ProfilePart part, int FriendDetail::*field)
+			{
+				HttpClient::getAsync(url, {}, {}, [this, userId, part, field](HttpClient::Response resp)
+				{
+					int count = 0;
+					bool ok = false;
+					if (resp.status_code >= 200 && resp.status_code < 300)
+					{
+						nlohmann::json j = HttpClient::decode(resp);
+						ok = j.is_object();
+						if (ok)
+							count = j.value("count", 0);
+					}
+					else
+					{
+						LOG_ERROR("Failed to fetch profile count: HTTP " + std::to_string(resp.status_code));
+					}
+					finishPart(userId, part, ok, [&](FriendDetail &d) { d.*field = count; });
+				});
+			}
+
+			template<typename Apply>
+			void finishPart(uint64_t userId, ProfilePart part, bool ok, Apply &&apply)
+			{
+				FriendDetail snapshot;
+				std::vector<Listener> listeners;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto it = entries_.find(userId);
+					if (it == entries_.end())
+						return;
+					Entry &e = it->second;
+					apply(e.detail);
+					e.detail.loaded |= part;
+					if (!ok)
+						e.detail.failed |= part;
+					snapshot = e.detail;
+					if (e.detail.loaded == ProfileAll)
+					{
+						e.inFlight = false;
+						if (e.detail.failed == 0)
+							e.fetchedAt = std::chrono::steady_clock::now();
+						listeners = std::move(e.listeners);
+						e.listeners.clear();
+					}
+					else
+					{
+						listeners = e.listeners;
+					}
 				}
+				for (auto &listener : listeners)
+					listener(snapshot);
 			}
-			signalDone(); });
-
-		Threading::newThread([&, userId]
-							 {
-			auto resp = HttpClient::get(
-				"https://friends.roblox.com/v1/users/" + userId + "/friends/count",
-				{}
-			);
-                        if (resp.status_code >= 200 && resp.status_code < 300) {
-				try {
-					d.friends = nlohmann::json::parse(resp.text).value("count", 0);
-				} catch (const std::exception &e) {
-					LOG_ERROR(std::string("Failed to parse friends count: ") + e.what());
+
+			// Drops everything that is not in flight and no longer servable, then,
+			// if the map is still full, the oldest servable entries. In-flight
+			// entries are never dropped, so the cap is exceeded only while more
+			// than kMaxEntries fetches are running at once.
+			void makeRoom()
+			{
+				std::vector<std::pair<std::chrono::steady_clock::time_point, uint64_t>> servable;
+				for (auto it = entries_.begin(); it != entries_.end();)
+				{
+					if (it->second.inFlight)
+						++it;
+					else if (!complete(it->second))
+						it = entries_.erase(it);
+					else
+					{
+						servable.emplace_back(it->second.fetchedAt, it->first);
+						++it;
+					}
+				}
+				if (entries_.size() < kMaxEntries)
+					return;
+				std::sort(servable.begin(), servable.end());
+				for (const auto &[fetchedAt, id] : servable)
+				{
+					if (entries_.size() < kMaxEntries)
+						break;
+					entries_.erase(id);
 				}
 			}
-			signalDone(); });
 
-		unique_lock<mutex> lk(m);
-		cv.wait(lk, [&]
-				{ return remaining == 0; });
+			mutable std::mutex mtx_;
+			std::unordered_map<uint64_t, Entry> entries_;
+	};
 
-		return d;
+	inline ProfileService &profileService()
+	{
+		static ProfileService service;
+		return service;
 	}
 
 	struct IncomingFriendRequest {
@@ -189,6 +367,35 @@ namespace Roblox
 		std::string prevCursor;
 	};
 
+    // Decodes a friend request listing straight into IncomingFriendRequest.
+    inline auto friendRequestsPageSax(FriendRequestsPage &page)
+    {
+        return HttpClient::makeArraySax(
+            "data", page.data,
+            [](IncomingFriendRequest &r, std::string_view key, nlohmann::json &v) {
+                if (key == "id")
+                    r.userId = HttpClient::saxUint(v);
+                else if (key == "name")
+                    r.username = HttpClient::saxString(v);
+                else if (key == "displayName")
+                    r.displayName = HttpClient::saxString(v);
+                else if (key == "friendRequest.sentAt")
+                    r.sentAt = HttpClient::saxString(v);
+                else if (key == "friendRequest.originSourceType")
+                    r.originSourceType = HttpClient::saxString(v);
+                else if (key == "friendRequest.sourceUniverseId")
+                    r.sourceUniverseId = HttpClient::saxUint(v);
+                else if (key == "mutualFriendsList" && v.is_string())
+                    r.mutuals.push_back(HttpClient::saxString(v));
+            },
+            [&page](std::string_view key, nlohmann::json &v) {
+                if (key == "nextPageCursor")
+                    page.nextCursor = HttpClient::saxString(v);
+                else if (key == "previousPageCursor")
+                    page.prevCursor = HttpClient::saxString(v);
+            });
+    }
+
     inline FriendRequestsPage getIncomingFriendRequests(const std::string &cookie,
                                                        const std::string &cursor = {},
                                                        int limit = 100)
@@ -199,57 +406,13 @@ namespace Roblox
         std::string url = "https://friends.roblox.com/v1/my/friends/requests?limit=" + std::to_string(limit);
         if (!cursor.empty()) url += "&cursor=" + cursor;
 
-        HttpClient::Response resp = HttpClient::get(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
+        auto sax = friendRequestsPageSax(page);
+        auto resp = HttpClient::getSax(url, sax, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
         if (resp.status_code < 200 || resp.status_code >= 300) {
             LOG_ERROR("Failed to fetch incoming friend requests: HTTP " + std::to_string(resp.status_code));
-            return page;
-        }
-
-        nlohmann::json j = HttpClient::decode(resp);
-        try {
-            if (j.contains("nextPageCursor") && j["nextPageCursor"].is_string())
-                page.nextCursor = j["nextPageCursor"].get<std::string>();
-            if (j.contains("previousPageCursor") && j["previousPageCursor"].is_string())
-                page.prevCursor = j["previousPageCursor"].get<std::string>();
-
-            if (j.contains("data") && j["data"].is_array()) {
-                for (const auto &it : j["data"]) {
-                    IncomingFriendRequest r;
-
-                    if (it.contains("id") && it["id"].is_number_unsigned())
-                        r.userId = it["id"].get<uint64_t>();
-
-                    if (it.contains("name") && it["name"].is_string())
-                        r.username = it["name"].get<std::string>();
-
-                    if (it.contains("displayName") && it["displayName"].is_string())
-                        r.displayName = it["displayName"].get<std::string>();
-
-                    if (it.contains("friendRequest") && it["friendRequest"].is_object()) {
-                        const auto &fr = it["friendRequest"];
-                        if (fr.contains("sentAt") && fr["sentAt"].is_string())
-                            r.sentAt = fr["sentAt"].get<std::string>();
-                        if (fr.contains("originSourceType") && fr["originSourceType"].is_string())
-                            r.originSourceType = fr["originSourceType"].get<std::string>();
-                        if (fr.contains("sourceUniverseId") && fr["sourceUniverseId"].is_number_unsigned())
-                            r.sourceUniverseId = fr["sourceUniverseId"].get<uint64_t>();
-                    }
-
-                    if (it.contains("mutualFriendsList") && it["mutualFriendsList"].is_array()) {
-                        for (const auto &m : it["mutualFriendsList"]) {
-                            if (m.is_string()) {
-                                try { r.mutuals.push_back(m.get<std::string>()); } catch (...) {}
-                            }
-                        }
-                    }
-
-                    page.data.push_back(std::move(r));
-                }
-            }
-        } catch (const std::exception &e) {
-            LOG_ERROR(std::string("Error parsing incoming friend requests: ") + e.what());
-            // Return whatever was safely parsed so far
+            return FriendRequestsPage{};
         }
+        // A truncated body keeps whatever was decoded before it broke off.
         return page;
     }
 
@@ -264,50 +427,127 @@ namespace Roblox
 		}
 		std::string url = "https://friends.roblox.com/v1/users/" + targetUserId + "/accept-friend-request";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse) *outResponse = "Missing CSRF token";
-			return false;
-		}
-
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}});
+		auto resp = authedPost(url, cookie);
 
 		if (outResponse) *outResponse = resp.text;
 		return resp.status_code >= 200 && resp.status_code < 300;
 	}
 
-	inline uint64_t getUserIdFromUsername(const std::string &username)
+	// Username -> userId for names resolved this session. Usernames are
+	// case-insensitive, so keys are lowercased; oldest names go first once full.
+	class UsernameCache {
+		public:
+			static constexpr size_t kMaxEntries = 4096;
+
+			std::optional<uint64_t> get(const std::string &lowerName) const {
+				std::shared_lock<std::shared_mutex> lock(mtx_);
+				auto it = ids_.find(lowerName);
+				if (it == ids_.end())
+					return std::nullopt;
+				return it->second;
+			}
+
+			void put(const std::string &lowerName, uint64_t id) {
+				std::unique_lock<std::shared_mutex> lock(mtx_);
+				if (!ids_.insert_or_assign(lowerName, id).second)
+					return;
+				order_.push_back(lowerName);
+				while (order_.size() > kMaxEntries) {
+					ids_.erase(order_.front());
+					order_.pop_front();
+				}
+			}
+
+		private:
+			mutable std::shared_mutex mtx_;
+			std::unordered_map<std::string, uint64_t> ids_;
+			std::deque<std::string> order_;
+	};
+
+	inline UsernameCache &usernameCache() {
+		static UsernameCache cache;
+		return cache;
+	}
+
+	// Resolves each specifier to a userId (0 if unknown), in input order. Names
+	// not cached yet are looked up 100 per request, so a pasted list of
+	// usernames costs a handful of requests instead of one each.
+	inline std::vector<uint64_t> resolveUserIds(const std::vector<UserSpecifier> &specs)
 	{
-		nlohmann::json payload = {
-			{"usernames", {username}},
-			{"excludeBannedUsers", true}};
+		constexpr size_t kBatchSize = 100;
 
-		auto resp = HttpClient::post(
-			"https://users.roblox.com/v1/usernames/users",
-			{},
-			payload.dump());
+		auto lower = [](std::string s) {
+			for (auto &c: s)
+				c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			return s;
+		};
 
-		if (resp.status_code < 200 || resp.status_code >= 300)
-		{
-			LOG_ERROR("Username lookup failed: HTTP " + std::to_string(resp.status_code));
-			return 0;
+		std::vector<uint64_t> ids(specs.size(), 0);
+		std::vector<std::string> pending;
+		std::unordered_set<std::string> queued;
+		for (size_t i = 0; i < specs.size(); ++i) {
+			if (specs[i].isId) {
+				ids[i] = specs[i].id;
+				continue;
+			}
+			std::string key = lower(specs[i].username);
+			if (auto cached = usernameCache().get(key))
+				ids[i] = *cached;
+			else if (queued.insert(key).second)
+				pending.push_back(specs[i].username);
 		}
 
-		auto j = HttpClient::decode(resp);
-		if (!j.contains("data") || j["data"].empty())
-		{
-			LOG_ERROR("Username not found");
-			return 0;
+		// Read back from here rather than the cache, which may already have
+		// evicted early names when the list is longer than it holds.
+		std::unordered_map<std::string, uint64_t> found;
+		for (size_t i = 0; i < pending.size(); i += kBatchSize) {
+			size_t end = (std::min)(pending.size(), i + kBatchSize);
+			nlohmann::json payload = {
+				{"usernames", std::vector<std::string>(pending.begin() + i, pending.begin() + end)},
+				{"excludeBannedUsers", true}};
+
+			auto resp = HttpClient::post(
+				"https://users.roblox.com/v1/usernames/users",
+				{},
+				payload.dump());
+
+			if (resp.status_code < 200 || resp.status_code >= 300)
+			{
+				LOG_ERROR("Username lookup failed: HTTP " + std::to_string(resp.status_code));
+				continue;
+			}
+
+			auto j = HttpClient::decode(resp);
+			if (!j.contains("data") || !j["data"].is_array())
+				continue;
+			for (const auto &entry: j["data"]) {
+				uint64_t id = entry.value("id", 0ULL);
+				std::string requested = entry.value("requestedUsername", "");
+				if (id == 0 || requested.empty())
+					continue;
+				std::string key = lower(requested);
+				usernameCache().put(key, id);
+				found[std::move(key)] = id;
+			}
 		}
 
-		return j["data"][0].value("id", 0ULL);
+		for (size_t i = 0; i < specs.size(); ++i) {
+			if (ids[i] != 0 || specs[i].isId)
+				continue;
+			auto it = found.find(lower(specs[i].username));
+			if (it != found.end())
+				ids[i] = it->second;
+			else
+				LOG_ERROR("Username not found: " + specs[i].username);
+		}
+		return ids;
+	}
+
+	inline uint64_t getUserIdFromUsername(const std::string &username)
+	{
+		UserSpecifier spec;
+		spec.username = username;
+		return resolveUserIds({spec}).front();
 	}
 
 	inline bool sendFriendRequest(const std::string &targetUserId,
@@ -323,26 +563,10 @@ namespace Roblox
 		std::string url = "https://friends.roblox.com/v1/users/" + targetUserId +
 						  "/request-friendship";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse)
-				*outResponse = "Missing CSRF token";
-			std::cerr << "friend request: missing CSRF token\n";
-			return false;
-		}
-
 		nlohmann::json body = {
 			{"friendshipOriginSourceType", 0}};
 
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}},
-			body.dump());
+		auto resp = authedPost(url, cookie, body.dump());
 
 		if (outResponse)
 			*outResponse = resp.text;
@@ -379,21 +603,7 @@ namespace Roblox
 		std::string url = "https://friends.roblox.com/v1/users/" + targetUserId +
 						  "/unfriend";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse)
-				*outResponse = "Missing CSRF token";
-			return false;
-		}
-
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}});
+		auto resp = authedPost(url, cookie);
 
 		if (outResponse)
 			*outResponse = resp.text;
@@ -418,21 +628,7 @@ namespace Roblox
 		}
 		std::string url = "https://friends.roblox.com/v1/users/" + targetUserId + "/follow";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse)
-				*outResponse = "Missing CSRF token";
-			return false;
-		}
-
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}});
+		auto resp = authedPost(url, cookie);
 
 		if (outResponse)
 			*outResponse = resp.text;
@@ -450,21 +646,7 @@ namespace Roblox
 		}
 		std::string url = "https://friends.roblox.com/v1/users/" + targetUserId + "/unfollow";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse)
-				*outResponse = "Missing CSRF token";
-			return false;
-		}
-
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}});
+		auto resp = authedPost(url, cookie);
 
 		if (outResponse)
 			*outResponse = resp.text;
@@ -482,27 +664,7 @@ namespace Roblox
 		}
 		std::string url = "https://www.roblox.com/users/" + targetUserId + "/block";
 
-		auto csrfResp = HttpClient::post(url, {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-		if (csrfResp.status_code < 200 || csrfResp.status_code >= 300)
-		{
-			if (outResponse)
-				*outResponse = "Failed CSRF";
-			return false;
-		}
-		auto it = csrfResp.headers.find("x-csrf-token");
-		if (it == csrfResp.headers.end())
-		{
-			if (outResponse)
-				*outResponse = "Missing CSRF token";
-			return false;
-		}
-
-		auto resp = HttpClient::post(
-			url,
-			{{"Cookie", ".ROBLOSECURITY=" + cookie},
-			 {"Origin", "https://www.roblox.com"},
-			 {"Referer", "https://www.roblox.com/"},
-			 {"X-CSRF-TOKEN", it->second}});
+		auto resp = authedPost(url, cookie);
 
 		if (outResponse)
 			*outResponse = resp.text;
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "http.hpp"
+#include "core/logging.hpp"
+#include "system/timers.h"
+
+namespace Roblox {
+	enum class ThumbnailKind {
+		Asset,
+		Avatar,
+		AvatarHeadshot,
+		GameIcon,
+	};
+
+	// Image bytes of one thumbnail, or empty if it could not be had.
+	using ThumbnailCallback = std::function<void(const std::string &image)>;
+
+	// Thumbnails for anything shown in a grid or list. Requests made within a
+	// short window are resolved together, one thumbnails.roblox.com call per
+	// kBatchSize ids of the same kind and size; the images themselves are
+	// then downloaded at most kMaxConcurrentDownloads at a time.
+	class ThumbnailService {
+		public:
+			static constexpr size_t kBatchSize = 100;
+			static constexpr auto kBatchWindow = std::chrono::milliseconds(30);
+			static constexpr size_t kMaxConcurrentDownloads = 16;
+			static constexpr size_t kMaxResolvedUrls = 4096;
+			// Avatars change whenever the user changes outfit; asset and game
+			// images rarely do.
+			static constexpr auto kAvatarUrlTtl = std::chrono::minutes(5);
+			static constexpr auto kImageUrlTtl = std::chrono::hours(1);
+
+			// `onDone` runs on a network thread; post to the main thread from it.
+			void request(ThumbnailKind kind, uint64_t id, const std::string &size, ThumbnailCallback onDone) {
+				Key key{kind, size, id};
+				bool scheduleFlush = false;
+				std::string url;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto resolved = resolvedUrls_.find(key);
+					if (resolved != resolvedUrls_.end() && resolved->second.expires <= std::chrono::steady_clock::now()) {
+						resolvedUrls_.erase(resolved);
+						resolved = resolvedUrls_.end();
+					}
+					if (resolved != resolvedUrls_.end()) {
+						url = resolved->second.url;
+					} else {
+						auto &waiters = pending_[key];
+						waiters.push_back(std::move(onDone));
+						if (waiters.size() > 1)
+							return; // same thumbnail already queued
+						scheduleFlush = !flushScheduled_;
+						flushScheduled_ = true;
+					}
+				}
+				if (!url.empty()) {
+					download(std::move(url), {std::move(onDone)});
+					return;
+				}
+				if (scheduleFlush) {
+					Timers::after(kBatchWindow, [this] { flush(); });
+				}
+			}
+
+		private:
+			struct Key {
+				ThumbnailKind kind;
+				std::string size;
+				uint64_t id;
+
+				bool operator<(const Key &o) const {
+					if (kind != o.kind)
+						return kind < o.kind;
+					if (size != o.size)
+						return size < o.size;
+					return id < o.id;
+				}
+			};
+
+			struct ResolvedUrl {
+				std::string url;
+				std::chrono::steady_clock::time_point expires;
+			};
+
+			struct Download {
+				std::string url;
+				std::vector<ThumbnailCallback> waiters;
+			};
+
+			static std::string batchUrl(ThumbnailKind kind, const std::string &size, const std::string &ids) {
+				std::string base;
+				switch (kind) {
+					case ThumbnailKind::Asset:
+						base = "https://thumbnails.roblox.com/v1/assets?assetIds=";
+						break;
+					case ThumbnailKind::Avatar:
+						base = "https://thumbnails.roblox.com/v1/users/avatar?userIds=";
+						break;
+					case ThumbnailKind::AvatarHeadshot:
+						base = "https://thumbnails.roblox.com/v1/users/avatar-headshot?userIds=";
+						break;
+					case ThumbnailKind::GameIcon:
+						base = "https://thumbnails.roblox.com/v1/games/icons?universeIds=";
+						break;
+				}
+				return base + ids + "&size=" + size + "&format=Png";
+			}
+
+			static std::chrono::steady_clock::duration urlTtl(ThumbnailKind kind) {
+				if (kind == ThumbnailKind::Avatar || kind == ThumbnailKind::AvatarHeadshot)
+					return kAvatarUrlTtl;
+				return kImageUrlTtl;
+			}
+
+			static void fail(const std::vector<ThumbnailCallback> &waiters) {
+				static const std::string none;
+				for (const auto &w: waiters)
+					w(none);
+			}
+
+			// Sends everything collected during the window; pending_ is ordered
+			// by kind and size, so each run of equal ones forms its batches.
+			void flush() {
+				std::map<Key, std::vector<ThumbnailCallback> > batch;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					batch.swap(pending_);
+					flushScheduled_ = false;
+				}
+				auto it = batch.begin();
+				while (it != batch.end()) {
+					auto group = std::make_shared<std::map<Key, std::vector<ThumbnailCallback> > >();
+					std::string ids;
+					const Key &first = it->first;
+					while (it != batch.end() && group->size() < kBatchSize && it->first.kind == first.kind &&
+					       it->first.size == first.size) {
+						if (!ids.empty())
+							ids += ',';
+						ids += std::to_string(it->first.id);
+						group->emplace(it->first, std::move(it->second));
+						++it;
+					}
+					std::string url = batchUrl(group->begin()->first.kind, group->begin()->first.size, ids);
+					HttpClient::getAsync(url, {}, {}, [this, group](HttpClient::Response resp) {
+						onBatch(*group, resp);
+					});
+				}
+			}
+
+			void onBatch(std::map<Key, std::vector<ThumbnailCallback> > &group, const HttpClient::Response &resp) {
+				if (resp.status_code < 200 || resp.status_code >= 300) {
+					LOG_ERROR("Thumbnail batch failed: HTTP " + std::to_string(resp.status_code));
+					for (auto &[key, waiters]: group)
+						fail(waiters);
+					return;
+				}
+
+				std::unordered_map<uint64_t, std::string> urls;
+				nlohmann::json j = HttpClient::decode(resp);
+				if (j.contains("data") && j["data"].is_array()) {
+					for (const auto &d: j["data"]) {
+						if (d.value("state", "") == "Completed" && d.contains("imageUrl") && d["imageUrl"].is_string())
+							urls[d.value("targetId", 0ULL)] = d["imageUrl"].get<std::string>();
+					}
+				}
+
+				for (auto &[key, waiters]: group) {
+					auto found = urls.find(key.id);
+					if (found == urls.end()) {
+						fail(waiters);
+						continue;
+					}
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+						if (resolvedUrls_.size() >= kMaxResolvedUrls)
+							resolvedUrls_.clear();
+						resolvedUrls_[key] = {found->second, std::chrono::steady_clock::now() + urlTtl(key.kind)};
+					}
+					download(found->second, std::move(waiters));
+				}
+			}
+
+			void download(std::string url, std::vector<ThumbnailCallback> waiters) {
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					downloads_.push_back({std::move(url), std::move(waiters)});
+				}
+				pump();
+			}
+
+			// Starts queued downloads while there is room. A download that
+			// completes inline (cache hit) re-enters here; the outer call on
+			// this thread carries on instead of recursing.
+			void pump() {
+				thread_local bool pumping = false;
+				if (pumping)
+					return;
+				pumping = true;
+				while (true) {
+					auto job = std::make_shared<Download>();
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+						if (downloads_.empty() || activeDownloads_ >= kMaxConcurrentDownloads)
+							break;
+						*job = std::move(downloads_.front());
+						downloads_.pop_front();
+						++activeDownloads_;
+					}
+					HttpClient::getAsync(job->url, {}, {}, [this, job](HttpClient::Response resp) {
+						if (resp.status_code >= 200 && resp.status_code < 300 && !resp.text.empty()) {
+							for (const auto &w: job->waiters)
+								w(resp.text);
+						} else {
+							fail(job->waiters);
+						}
+						{
+							std::lock_guard<std::mutex> lock(mtx_);
+							--activeDownloads_;
+						}
+						pump();
+					});
+				}
+				pumping = false;
+			}
+
+			std::mutex mtx_;
+			std::map<Key, std::vector<ThumbnailCallback> > pending_;
+			bool flushScheduled_ = false;
+			std::map<Key, ResolvedUrl> resolvedUrls_;
+			std::deque<Download> downloads_;
+			size_t activeDownloads_ = 0;
+	};
+
+	inline ThumbnailService &thumbnails() {
+		static ThumbnailService service;
+		return service;
+	}
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "auth.h"
+#include "csrf.h"
+#include "system/threading.h"
+
+namespace Roblox {
+	// Authentication tickets minted ahead of a launch, so starting many clients
+	// isn't gated on a CSRF handshake plus a ticket request per account. A
+	// ticket is single-use and only honoured briefly, so pooled ones are handed
+	// out once and thrown away after kTicketTtl.
+	class AuthTicketPool {
+		public:
+			static constexpr auto kTicketTtl = std::chrono::seconds(60);
+			static constexpr size_t kMaxConcurrentMints = 8;
+			static constexpr auto kPendingWait = std::chrono::seconds(10);
+
+			static AuthTicketPool &instance() {
+				static AuthTicketPool pool;
+				return pool;
+			}
+
+			// Starts minting, up to kMaxConcurrentMints at a time, for every cookie
+			// that has no fresh or pending ticket. Returns immediately.
+			void prefill(const std::vector<std::string> &cookies) {
+				auto work = std::make_shared<MintQueue>();
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					dropExpired();
+					for (const auto &cookie: cookies) {
+						if (cookie.empty())
+							continue;
+						auto [it, inserted] = slots_.try_emplace(cookieDigest(cookie));
+						if (!inserted)
+							continue;
+						it->second.pending = true;
+						work->cookies.push_back(cookie);
+					}
+				}
+				size_t workers = (std::min)(kMaxConcurrentMints, work->cookies.size());
+				for (size_t i = 0; i < workers; ++i) {
+					Threading::background([this, work] {
+						for (size_t k = work->next++; k < work->cookies.size(); k = work->next++)
+							mint(work->cookies[k]);
+					});
+				}
+			}
+
+			// A pooled ticket for `cookie` (waiting for one still being minted),
+			// otherwise one minted on the spot.
+			std::string take(const std::string &cookie) {
+				{
+					std::unique_lock<std::mutex> lock(mtx_);
+					uint64_t key = cookieDigest(cookie);
+					auto it = slots_.find(key);
+					if (it != slots_.end() && it->second.pending) {
+						cv_.wait_for(lock, kPendingWait, [&] {
+							auto cur = slots_.find(key);
+							return cur == slots_.end() || !cur->second.pending;
+						});
+						it = slots_.find(key);
+					}
+					if (it != slots_.end() && !it->second.pending) {
+						bool fresh = std::chrono::steady_clock::now() - it->second.mintedAt < kTicketTtl;
+						std::string ticket = std::move(it->second.ticket);
+						slots_.erase(it);
+						if (fresh)
+							return ticket;
+					}
+				}
+				return requestAuthTicket(cookie);
+			}
+
+			size_t ready() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return std::count_if(slots_.begin(), slots_.end(), [](const auto &s) { return !s.second.pending; });
+			}
+
+		private:
+			struct Slot {
+				std::string ticket;
+				std::chrono::steady_clock::time_point mintedAt;
+				bool pending = false;
+			};
+
+			struct MintQueue {
+				std::vector<std::string> cookies;
+				std::atomic<size_t> next{0};
+			};
+
+			void mint(const std::string &cookie) {
+				std::string ticket = requestAuthTicket(cookie);
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					auto it = slots_.find(cookieDigest(cookie));
+					if (it != slots_.end()) {
+						if (ticket.empty()) {
+							slots_.erase(it);
+						} else {
+							it->second.ticket = std::move(ticket);
+							it->second.mintedAt = std::chrono::steady_clock::now();
+							it->second.pending = false;
+						}
+					}
+				}
+				cv_.notify_all();
+			}
+
+			void dropExpired() {
+				auto now = std::chrono::steady_clock::now();
+				for (auto it = slots_.begin(); it != slots_.end();) {
+					if (!it->second.pending && now - it->second.mintedAt >= kTicketTtl)
+						it = slots_.erase(it);
+					else
+						++it;
+				}
+			}
+
+			mutable std::mutex mtx_;
+			std::condition_variable cv_;
+			std::unordered_map<uint64_t, Slot> slots_;
+	};
+
+	inline std::string takeAuthTicket(const std::string &cookie) {
+		return AuthTicketPool::instance().take(cookie);
+	}
+}
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
 #include "network/http.hpp"
+#include "network/roblox/auth.h"
+#include "network/roblox/ticket_pool.h"
 #include <iostream>
 #include <chrono>
 #include <sstream>
@@ -38,31 +40,8 @@ static string urlEncode(const string &s) {
 
 #ifdef _WIN32
 inline HANDLE startRoblox(uint64_t placeId, const string &jobId, const string &cookie) {
-    LOG_INFO("Fetching x-csrf token");
-    auto csrfResponse = HttpClient::post(
-        "https://auth.roblox.com/v1/authentication-ticket",
-        {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-
-    auto csrfToken = csrfResponse.headers.find("x-csrf-token");
-    if (csrfToken == csrfResponse.headers.end()) {
-        cerr << "failed to get CSRF token\n";
-        LOG_ERROR("Failed to get CSRF token");
-        return nullptr;
-    }
-
-    LOG_INFO("Fetching authentication ticket");
-    auto ticketResponse = HttpClient::post(
-        "https://auth.roblox.com/v1/authentication-ticket",
-        {
-            {"Cookie", ".ROBLOSECURITY=" + cookie},
-            {"Origin", "https://www.roblox.com"},
-            {"Referer", "https://www.roblox.com/"},
-            {"X-CSRF-TOKEN", csrfToken->second}
-        });
-
-    auto ticket = ticketResponse.headers.find("rbx-authentication-ticket");
-    if (ticket == ticketResponse.headers.end()) {
-        cerr << "failed to get authentication ticket\n";
+    std::string ticket = Roblox::takeAuthTicket(cookie);
+    if (ticket.empty()) {
         LOG_ERROR("Failed to get authentication ticket");
         return nullptr;
     }
@@ -89,7 +68,7 @@ inline HANDLE startRoblox(uint64_t placeId, const string &jobId, const string &c
     string protocolLaunchCommand =
             "roblox-player:1+launchmode:play"
             "+gameinfo:" +
-            ticket->second +
+            ticket +
             "+launchtime:" + ts.str() +
             "+placelauncherurl:" + urlEncode(placeLauncherUrl);
 
@@ -124,31 +103,8 @@ inline HANDLE startRoblox(uint64_t placeId, const string &jobId, const string &c
 #elif __APPLE__
 
 inline bool startRoblox(uint64_t placeId, const string &jobId, const string &cookie) {
-    LOG_INFO("Fetching x-csrf token");
-    auto csrfResponse = HttpClient::post(
-        "https://auth.roblox.com/v1/authentication-ticket",
-        {{"Cookie", ".ROBLOSECURITY=" + cookie}});
-
-    auto csrfToken = csrfResponse.headers.find("x-csrf-token");
-    if (csrfToken == csrfResponse.headers.end()) {
-        cerr << "failed to get CSRF token\n";
-        LOG_ERROR("Failed to get CSRF token");
-        return false;
-    }
-
-    LOG_INFO("Fetching authentication ticket");
-    auto ticketResponse = HttpClient::post(
-        "https://auth.roblox.com/v1/authentication-ticket",
-        {
-            {"Cookie", ".ROBLOSECURITY=" + cookie},
-            {"Origin", "https://www.roblox.com"},
-            {"Referer", "https://www.roblox.com/"},
-            {"X-CSRF-TOKEN", csrfToken->second}
-        });
-
-    auto ticket = ticketResponse.headers.find("rbx-authentication-ticket");
-    if (ticket == ticketResponse.headers.end()) {
-        cerr << "failed to get authentication ticket\n";
+    std::string ticket = Roblox::takeAuthTicket(cookie);
+    if (ticket.empty()) {
         LOG_ERROR("Failed to get authentication ticket");
         return false;
     }
@@ -175,7 +131,7 @@ inline bool startRoblox(uint64_t placeId, const string &jobId, const string &coo
     string protocolLaunchCommand =
             "roblox-player:1+launchmode:play"
             "+gameinfo:" +
-            ticket->second +
+            ticket +
             "+launchtime:" + ts.str() +
             "+placelauncherurl:" + urlEncode(placeLauncherUrl);
 
@@ -210,6 +166,16 @@ inline void launchRobloxSequential(uint64_t placeId, const std::string &jobId,
     if (g_clearCacheOnLaunch)
         RobloxControl::ClearRobloxCache();
 
+    // Mint every account's ticket up front so later launches don't wait on one.
+    // Each ticket is used moments later, so this doesn't need the pre-mint setting.
+    if (accounts.size() > 1) {
+        std::vector<std::string> cookies;
+        cookies.reserve(accounts.size());
+        for (const auto &[accountId, cookie]: accounts)
+            cookies.push_back(cookie);
+        Roblox::AuthTicketPool::instance().prefill(cookies);
+    }
+
     for (const auto &[accountId, cookie]: accounts) {
         LOG_INFO("Launching Roblox for account ID: " + std::to_string(accountId) +
             " PlaceID: " + std::to_string(placeId) +
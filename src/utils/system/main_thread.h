@@ -1,25 +1,217 @@
 #pragma once
-#include <functional>
-#include <deque>
-#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace MainThread {
-	using Task = std::function<void()>;
-	inline std::deque<Task> tasks;
-	inline std::mutex mtx;
+	// Move-only callable that keeps closures up to kInlineSize bytes inside
+	// itself, so a typical Post() costs one allocation (its queue node).
+	class Task {
+		public:
+			static constexpr std::size_t kInlineSize = 64;
+
+			Task() = default;
+
+			template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+			Task(F &&f) {
+				using Fn = std::decay_t<F>;
+				if constexpr (sizeof(Fn) <= kInlineSize && alignof(Fn) <= alignof(std::max_align_t) &&
+				              std::is_nothrow_move_constructible_v<Fn>) {
+					new (&storage_) Fn(std::forward<F>(f));
+					ops_ = &inlineOps<Fn>;
+				} else {
+					*reinterpret_cast<Fn **>(&storage_) = new Fn(std::forward<F>(f));
+					ops_ = &heapOps<Fn>;
+				}
+			}
+
+			Task(Task &&other) noexcept : ops_(other.ops_) {
+				if (ops_)
+					ops_->move(&storage_, &other.storage_);
+				other.ops_ = nullptr;
+			}
+
+			Task &operator=(Task &&other) noexcept {
+				if (this != &other) {
+					reset();
+					ops_ = other.ops_;
+					if (ops_)
+						ops_->move(&storage_, &other.storage_);
+					other.ops_ = nullptr;
+				}
+				return *this;
+			}
+
+			Task(const Task &) = delete;
+			Task &operator=(const Task &) = delete;
+
+			~Task() { reset(); }
+
+			explicit operator bool() const { return ops_ != nullptr; }
+			void operator()() { ops_->call(&storage_); }
+
+		private:
+			struct Ops {
+				void (*call)(void *);
+				void (*move)(void *dst, void *src); // leaves src destroyed
+				void (*destroy)(void *);
+			};
+
+			template<typename Fn>
+			static constexpr Ops inlineOps{
+				[](void *p) { (*static_cast<Fn *>(p))(); },
+				[](void *dst, void *src) {
+					new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+					static_cast<Fn *>(src)->~Fn();
+				},
+				[](void *p) { static_cast<Fn *>(p)->~Fn(); }
+			};
+
+			template<typename Fn>
+			static constexpr Ops heapOps{
+				[](void *p) { (**static_cast<Fn **>(p))(); },
+				[](void *dst, void *src) { *static_cast<Fn **>(dst) = *static_cast<Fn **>(src); },
+				[](void *p) { delete *static_cast<Fn **>(p); }
+			};
+
+			void reset() {
+				if (ops_)
+					ops_->destroy(&storage_);
+				ops_ = nullptr;
+			}
+
+			alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+			const Ops *ops_ = nullptr;
+	};
+
+	// Intrusive multi-producer single-consumer queue (Vyukov): Post() from any
+	// thread is one atomic exchange, only the UI thread pops.
+	class TaskQueue {
+		public:
+			struct Stats {
+				std::size_t backlog = 0;     // waiting right now
+				std::size_t lastRan = 0;     // run by the last Process()
+				std::size_t lastLeftOver = 0; // carried over by the last Process()
+				double lastMs = 0.0;
+			};
+
+			TaskQueue() : head_(&stub_), tail_(&stub_) {}
+
+			~TaskQueue() {
+				while (Node *n = pop())
+					delete n;
+			}
+
+			void push(Task task) {
+				Node *n = new Node(std::move(task));
+				pending_.fetch_add(1, std::memory_order_relaxed);
+				link(n);
+			}
+
+			// Runs queued tasks until `budget` is spent, at least one per call so
+			// the queue always drains. Tasks posted while this runs wait for the
+			// next frame.
+			void process(std::chrono::microseconds budget) {
+				auto start = std::chrono::steady_clock::now();
+				std::size_t limit = pending_.load(std::memory_order_acquire);
+				std::size_t ran = 0;
+				while (ran < limit) {
+					Node *n = pop();
+					if (!n)
+						break; // a producer is between its exchange and its link
+					pending_.fetch_sub(1, std::memory_order_relaxed);
+					n->task();
+					delete n;
+					++ran;
+					if (std::chrono::steady_clock::now() - start >= budget)
+						break;
+				}
+				lastRan_ = ran;
+				lastLeftOver_ = pending_.load(std::memory_order_relaxed);
+				lastMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+
+			std::size_t backlog() const { return pending_.load(std::memory_order_relaxed); }
+
+			// Meant for the UI thread, which is the only writer of the last* fields.
+			Stats stats() const { return {backlog(), lastRan_, lastLeftOver_, lastMs_}; }
+
+		private:
+			struct Node {
+				Node() = default;
+				explicit Node(Task t) : task(std::move(t)) {}
+
+				std::atomic<Node *> next{nullptr};
+				Task task;
+			};
+
+			void link(Node *n) {
+				n->next.store(nullptr, std::memory_order_relaxed);
+				Node *prev = head_.exchange(n, std::memory_order_acq_rel);
+				prev->next.store(n, std::memory_order_release);
+			}
+
+			Node *pop() {
+				Node *tail = tail_;
+				Node *next = tail->next.load(std::memory_order_acquire);
+				if (tail == &stub_) {
+					if (!next)
+						return nullptr;
+					tail_ = next;
+					tail = next;
+					next = next->next.load(std::memory_order_acquire);
+				}
+				if (next) {
+					tail_ = next;
+					return tail;
+				}
+				if (tail != head_.load(std::memory_order_acquire))
+					return nullptr;
+				link(&stub_);
+				next = tail->next.load(std::memory_order_acquire);
+				if (next) {
+					tail_ = next;
+					return tail;
+				}
+				return nullptr;
+			}
+
+			std::atomic<Node *> head_; // producers
+			Node *tail_;               // consumer
+			Node stub_;
+			std::atomic<std::size_t> pending_{0};
+
+			std::size_t lastRan_ = 0;
+			std::size_t lastLeftOver_ = 0;
+			double lastMs_ = 0.0;
+	};
+
+	inline constexpr auto kDefaultFrameBudget = std::chrono::milliseconds(4);
+
+	inline TaskQueue &queue() {
+		// Never destroyed: pool workers may still post while the app exits.
+		static TaskQueue *q = new TaskQueue();
+		return *q;
+	}
 
 	inline void Post(Task t) {
-		std::lock_guard<std::mutex> lock(mtx);
-		tasks.push_back(std::move(t));
+		queue().push(std::move(t));
+	}
+
+	// Called once per frame from the UI thread; work beyond `budget` carries
+	// over to the next frame instead of stretching this one.
+	inline void Process(std::chrono::microseconds budget = kDefaultFrameBudget) {
+		queue().process(budget);
+	}
+
+	inline std::size_t Backlog() {
+		return queue().backlog();
 	}
 
-	inline void Process() {
-		std::deque<Task> toRun; {
-			std::lock_guard<std::mutex> lock(mtx);
-			toRun.swap(tasks);
-		}
-		for (auto &t: toRun) {
-			t();
-		}
+	inline TaskQueue::Stats LastStats() {
+		return queue().stats();
 	}
 }
@@ -1,11 +1,299 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <tuple>
 #include <utility>
 
+#include "core/logging.hpp"
+#include "network/http_metrics.hpp"
+
 namespace Threading {
-	// Launches f(args...) on a detached background thread.
+	// Interactive work answers something the user just did and is always
+	// picked before background work (refresh timers, pre-fetching).
+	enum class Lane { Interactive = 0, Background = 1 };
+
+	struct LaneStats {
+		size_t queued = 0;
+		uint64_t completed = 0;
+		double waitP50Ms = 0.0; // submit -> start
+		double waitP95Ms = 0.0;
+		double runP95Ms = 0.0;
+	};
+
+	struct PoolStats {
+		size_t workers = 0;
+		size_t coreWorkers = 0;
+		size_t busy = 0;
+		std::array<LaneStats, 2> lanes{};
+	};
+
+	// Fixed set of core workers (one per hardware thread), each with its own
+	// deque that idle workers steal from, plus one shared queue per lane for
+	// tasks submitted from outside the pool. Many tasks block on the network,
+	// so when every worker has been busy with work still queued for a while, a
+	// watchdog adds overflow workers (up to kMaxWorkers) that retire once idle.
+	class ThreadPool {
+		public:
+			using Task = std::function<void()>;
+
+			static constexpr size_t kMaxWorkers = 64;
+			static constexpr auto kStallAfter = std::chrono::milliseconds(200);
+			static constexpr auto kOverflowIdleRetire = std::chrono::seconds(15);
+
+			static ThreadPool &instance() {
+				// Never destroyed: detached workers may still be finishing a
+				// request while static destructors run at exit.
+				static ThreadPool *pool = new ThreadPool();
+				return *pool;
+			}
+
+			void submit(Lane lane, Task fn) {
+				Item item{std::move(fn), std::chrono::steady_clock::now()};
+				size_t l = static_cast<size_t>(lane);
+				int self = t_worker;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					if (stopping_)
+						return;
+					if (self >= 0) {
+						// From a core worker: keep it local, others steal if idle.
+						std::lock_guard<std::mutex> local(core_[self].mtx);
+						core_[self].queues[l].push_back(std::move(item));
+					} else {
+						shared_[l].push_back(std::move(item));
+					}
+					++pending_;
+					++queued_[l];
+				}
+				cv_.notify_one();
+			}
+
+			PoolStats stats() const {
+				PoolStats s;
+				s.coreWorkers = coreCount_;
+				s.workers = workers_.load();
+				s.busy = busy_.load();
+				std::lock_guard<std::mutex> lock(statsMtx_);
+				for (size_t l = 0; l < 2; ++l) {
+					auto &out = s.lanes[l];
+					out.queued = queued_[l].load();
+					out.completed = wait_[l].count();
+					out.waitP50Ms = wait_[l].percentile(0.50);
+					out.waitP95Ms = wait_[l].percentile(0.95);
+					out.runP95Ms = run_[l].percentile(0.95);
+				}
+				return s;
+			}
+
+			// Drops queued work, stops the workers and waits up to `grace` for
+			// running tasks; anything still running after that is left behind.
+			void shutdown(std::chrono::milliseconds grace = std::chrono::milliseconds(500)) {
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					if (stopping_)
+						return;
+					stopping_ = true;
+					for (auto &q: shared_)
+						q.clear();
+					for (size_t i = 0; i < coreCount_; ++i) {
+						std::lock_guard<std::mutex> local(core_[i].mtx);
+						for (auto &q: core_[i].queues)
+							q.clear();
+					}
+					pending_ = 0;
+					queued_[0] = queued_[1] = 0;
+				}
+				cv_.notify_all();
+				std::unique_lock<std::mutex> lock(mtx_);
+				exitCv_.wait_for(lock, grace, [&] { return workers_.load() == 0; });
+			}
+
+		private:
+			struct Item {
+				Task fn;
+				std::chrono::steady_clock::time_point enqueued;
+			};
+
+			struct CoreWorker {
+				std::mutex mtx;
+				std::array<std::deque<Item>, 2> queues;
+			};
+
+			ThreadPool() {
+				coreCount_ = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, kMaxWorkers);
+				core_ = std::make_unique<CoreWorker[]>(coreCount_);
+				for (size_t i = 0; i < coreCount_; ++i)
+					spawn(static_cast<int>(i));
+				std::thread([this] { watchdog(); }).detach();
+			}
+
+			inline static thread_local int t_worker = -1; // core worker index, -1 elsewhere
+
+			void spawn(int coreIndex) {
+				++workers_;
+				std::thread([this, coreIndex] { work(coreIndex); }).detach();
+			}
+
+			// Own deque newest-first, then the shared queue, then the oldest task
+			// of another core worker; interactive before background throughout.
+			bool take(int self, Item &out, size_t &lane) {
+				for (lane = 0; lane < 2; ++lane) {
+					if (self >= 0) {
+						std::lock_guard<std::mutex> local(core_[self].mtx);
+						auto &q = core_[self].queues[lane];
+						if (!q.empty()) {
+							out = std::move(q.back());
+							q.pop_back();
+							return claimed(lane);
+						}
+					}
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+						auto &q = shared_[lane];
+						if (!q.empty()) {
+							out = std::move(q.front());
+							q.pop_front();
+							return claimed(lane);
+						}
+					}
+					for (size_t i = 0; i < coreCount_; ++i) {
+						if (static_cast<int>(i) == self)
+							continue;
+						std::lock_guard<std::mutex> local(core_[i].mtx);
+						auto &q = core_[i].queues[lane];
+						if (!q.empty()) {
+							out = std::move(q.front());
+							q.pop_front();
+							return claimed(lane);
+						}
+					}
+				}
+				return false;
+			}
+
+			bool claimed(size_t lane) {
+				--pending_;
+				--queued_[lane];
+				lastStart_.store(std::chrono::steady_clock::now().time_since_epoch().count());
+				return true;
+			}
+
+			void work(int coreIndex) {
+				t_worker = coreIndex;
+				bool overflow = coreIndex < 0;
+				while (true) {
+					Item item;
+					size_t lane = 0;
+					if (take(coreIndex, item, lane)) {
+						run(item, lane);
+						continue;
+					}
+					std::unique_lock<std::mutex> lock(mtx_);
+					auto ready = [&] { return pending_.load() > 0 || stopping_; };
+					bool woke = overflow ? cv_.wait_for(lock, kOverflowIdleRetire, ready) : (cv_.wait(lock, ready), true);
+					if (stopping_ || !woke)
+						break;
+				}
+				if (--workers_ == 0) {
+					std::lock_guard<std::mutex> lock(mtx_);
+					exitCv_.notify_all();
+				}
+			}
+
+			void run(Item &item, size_t lane) {
+				auto start = std::chrono::steady_clock::now();
+				++busy_;
+				try {
+					item.fn();
+				} catch (const std::exception &e) {
+					LOG_ERROR(std::string("Background task failed: ") + e.what());
+				} catch (...) {
+					LOG_ERROR("Background task failed");
+				}
+				--busy_;
+				auto end = std::chrono::steady_clock::now();
+				std::lock_guard<std::mutex> lock(statsMtx_);
+				wait_[lane].record(std::chrono::duration<double, std::milli>(start - item.enqueued).count());
+				run_[lane].record(std::chrono::duration<double, std::milli>(end - start).count());
+			}
+
+			// Adds an overflow worker whenever work has been waiting with every
+			// worker busy and nothing started for kStallAfter.
+			void watchdog() {
+				while (true) {
+					std::this_thread::sleep_for(kStallAfter / 2);
+					{
+						std::lock_guard<std::mutex> lock(mtx_);
+						if (stopping_)
+							return;
+					}
+					auto since = std::chrono::steady_clock::now() -
+					             std::chrono::steady_clock::time_point(
+						             std::chrono::steady_clock::duration(lastStart_.load()));
+					if (pending_.load() > 0 && busy_.load() >= workers_.load() && since >= kStallAfter &&
+					    workers_.load() < kMaxWorkers) {
+						lastStart_.store(std::chrono::steady_clock::now().time_since_epoch().count());
+						spawn(-1);
+					}
+				}
+			}
+
+			size_t coreCount_ = 0;
+			std::unique_ptr<CoreWorker[]> core_;
+
+			mutable std::mutex mtx_; // shared queues, stopping_, sleeping workers
+			std::condition_variable cv_;
+			std::condition_variable exitCv_;
+			std::array<std::deque<Item>, 2> shared_;
+			bool stopping_ = false;
+
+			std::atomic<size_t> pending_{0};
+			std::array<std::atomic<size_t>, 2> queued_{};
+			std::atomic<size_t> workers_{0};
+			std::atomic<size_t> busy_{0};
+			std::atomic<std::chrono::steady_clock::rep> lastStart_{0};
+
+			mutable std::mutex statsMtx_;
+			std::array<HttpClient::LatencyHistogram, 2> wait_;
+			std::array<HttpClient::LatencyHistogram, 2> run_;
+	};
+
+	template<typename Func, typename... Args>
+	void submit(Lane lane, Func &&f, Args &&... args) {
+		ThreadPool::instance().submit(lane,
+			[fn = std::forward<Func>(f),
+				tup = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+				std::apply(fn, tup);
+			});
+	}
+
+	// Runs f(args...) on the pool's interactive lane. Kept under its old name
+	// from when every call started its own detached thread.
 	template<typename Func, typename... Args>
 	void newThread(Func &&f, Args &&... args) {
+		submit(Lane::Interactive, std::forward<Func>(f), std::forward<Args>(args)...);
+	}
+
+	// Runs f(args...) on the pool's background lane.
+	template<typename Func, typename... Args>
+	void background(Func &&f, Args &&... args) {
+		submit(Lane::Background, std::forward<Func>(f), std::forward<Args>(args)...);
+	}
+
+	// Launches f(args...) on its own detached thread, for loops that live as
+	// long as the program or an operation and would otherwise pin a worker.
+	template<typename Func, typename... Args>
+	void longRunning(Func &&f, Args &&... args) {
 		std::thread(
 			[fn = std::forward<Func>(f),
 				tup = std::make_tuple(std::forward<Args>(args)...)]() mutable {
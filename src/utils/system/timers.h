@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/logging.hpp"
+
+namespace Timers {
+	using Clock = std::chrono::steady_clock;
+	using Task = std::function<void()>;
+
+	// Identifies a scheduled timer for cancel(); 0 is never issued.
+	using Handle = uint64_t;
+
+	// One thread serving every delayed and periodic callback in the app from a
+	// min-heap of due times. Callbacks run on that thread one at a time and
+	// must stay short: hand blocking work to Threading and UI state changes to
+	// MainThread::Post.
+	class TimerService {
+		public:
+			static TimerService &instance() {
+				// Never destroyed: timers may be scheduled while the app exits.
+				static TimerService *service = new TimerService();
+				return *service;
+			}
+
+			Handle at(Clock::time_point due, Task task) {
+				return schedule(due, Clock::duration::zero(), std::move(task));
+			}
+
+			Handle after(Clock::duration delay, Task task) {
+				return schedule(Clock::now() + delay, Clock::duration::zero(), std::move(task));
+			}
+
+			// Runs `task` every `interval`, the first time one interval from now.
+			// A run that overshoots skips the missed ticks instead of bunching up.
+			Handle every(Clock::duration interval, Task task) {
+				return schedule(Clock::now() + interval, interval, std::move(task));
+			}
+
+			// False if the timer already fired (one-shot) or was cancelled. A
+			// callback running right now finishes, but a periodic one stops there.
+			bool cancel(Handle handle) {
+				if (handle == 0)
+					return false;
+				std::lock_guard<std::mutex> lock(mtx_);
+				return timers_.erase(handle) != 0;
+			}
+
+			size_t pending() const {
+				std::lock_guard<std::mutex> lock(mtx_);
+				return timers_.size();
+			}
+
+		private:
+			struct Timer {
+				Task task; // empty while a periodic callback is running
+				Clock::duration interval;
+			};
+
+			struct Due {
+				Clock::time_point at;
+				Handle handle;
+
+				bool operator>(const Due &o) const { return at > o.at; }
+			};
+
+			TimerService() {
+				std::thread([this] { run(); }).detach();
+			}
+
+			Handle schedule(Clock::time_point due, Clock::duration interval, Task task) {
+				Handle handle;
+				bool earliest;
+				{
+					std::lock_guard<std::mutex> lock(mtx_);
+					handle = nextHandle_++;
+					timers_.emplace(handle, Timer{std::move(task), interval});
+					earliest = heap_.empty() || due < heap_.front().at;
+					push(due, handle);
+				}
+				if (earliest)
+					cv_.notify_one();
+				return handle;
+			}
+
+			void push(Clock::time_point due, Handle handle) {
+				heap_.push_back({due, handle});
+				std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+				// Cancelled timers stay in the heap until due; rebuild once they
+				// outnumber the live ones.
+				if (heap_.size() > 64 && heap_.size() > 2 * timers_.size()) {
+					std::erase_if(heap_, [&](const Due &d) { return !timers_.count(d.handle); });
+					std::make_heap(heap_.begin(), heap_.end(), std::greater<>());
+				}
+			}
+
+			void run() {
+				std::unique_lock<std::mutex> lock(mtx_);
+				while (true) {
+					if (heap_.empty()) {
+						cv_.wait(lock);
+						continue;
+					}
+					Due next = heap_.front();
+					auto now = Clock::now();
+					if (next.at > now) {
+						cv_.wait_until(lock, next.at);
+						continue;
+					}
+					std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+					heap_.pop_back();
+
+					auto it = timers_.find(next.handle);
+					if (it == timers_.end())
+						continue; // cancelled
+					Task task = std::move(it->second.task);
+					auto interval = it->second.interval;
+					if (interval == Clock::duration::zero())
+						timers_.erase(it);
+
+					lock.unlock();
+					try {
+						task();
+					} catch (const std::exception &e) {
+						LOG_ERROR(std::string("Timer callback failed: ") + e.what());
+					} catch (...) {
+						LOG_ERROR("Timer callback failed");
+					}
+					lock.lock();
+
+					if (interval == Clock::duration::zero())
+						continue;
+					it = timers_.find(next.handle);
+					if (it == timers_.end())
+						continue; // cancelled while running
+					it->second.task = std::move(task);
+					auto due = next.at + interval;
+					now = Clock::now();
+					if (due <= now)
+						due = now + interval - (now - next.at) % interval;
+					push(due, next.handle);
+				}
+			}
+
+			mutable std::mutex mtx_;
+			std::condition_variable cv_;
+			std::vector<Due> heap_;
+			std::unordered_map<Handle, Timer> timers_;
+			Handle nextHandle_ = 1;
+	};
+
+	inline Handle at(Clock::time_point due, Task task) {
+		return TimerService::instance().at(due, std::move(task));
+	}
+
+	inline Handle after(Clock::duration delay, Task task) {
+		return TimerService::instance().after(delay, std::move(task));
+	}
+
+	inline Handle every(Clock::duration interval, Task task) {
+		return TimerService::instance().every(interval, std::move(task));
+	}
+
+	inline bool cancel(Handle handle) {
+		return TimerService::instance().cancel(handle);
+	}
+
+	// Runs the task from the latest call() once `delay` passes without another
+	// call, e.g. to save a file once after a burst of edits.
+	class Debouncer {
+		public:
+			explicit Debouncer(Clock::duration delay) : delay_(delay) {}
+
+			void call(Task task) {
+				std::lock_guard<std::mutex> lock(mtx_);
+				cancel(handle_);
+				handle_ = after(delay_, std::move(task));
+			}
+
+		private:
+			Clock::duration delay_;
+			std::mutex mtx_;
+			Handle handle_ = 0;
+	};
+}
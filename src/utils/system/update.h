@@ -25,7 +25,7 @@ inline void OpenURL(const std::string& url) {
 }
 
 inline void CheckForUpdates() {
-    Threading::newThread([]() {
+    Threading::background([]() {
         const std::string url = "https://api.github.com/repos/crowsyndrome/altman/releases/latest";
         auto resp = HttpClient::get(url, {{"User-Agent", "AltMan"}, {"Accept", "application/vnd.github+json"}});
         if (resp.status_code != 200) {